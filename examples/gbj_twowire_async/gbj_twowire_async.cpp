@@ -0,0 +1,89 @@
+/*
+  NAME:
+  Asynchronous transfers of gbjTwoWire library.
+
+  DESCRIPTION:
+  The sketch reads a data block from a device with a receive delay, which
+  simulates a sensor conversion time, asynchronously, so that the loop keeps
+  running other tasks in the meantime, and counts them.
+  * On a microcontroller a device at ADDRESS_DEVICE acknowledging reads is
+    needed, e.g., a serial EEPROM.
+  * On a Linux host (see README) a virtual memory device is attached to the
+    simulated bus.
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#include "gbj_twowire.h"
+
+const byte ADDRESS_DEVICE = 0x50;
+const uint32_t DELAY_RECEIVE = 20;
+const byte CYCLES = 3;
+
+uint8_t data[64];
+uint32_t tasks;
+gbj_twowire device = gbj_twowire();
+
+#if defined(GBJ_TWOWIRE_SIM)
+uint8_t memory[256];
+gbj_twowire_sim_memory simDevice(ADDRESS_DEVICE, memory, sizeof(memory), 0);
+#endif
+
+void errorHandler(String location)
+{
+  Serial.println(device.getLastErrorTxt(location));
+  Serial.println("---");
+}
+
+void completionHandler(gbj_twowire::ResultCodes result)
+{
+  if (device.isError(result))
+  {
+    errorHandler("Receive");
+    return;
+  }
+  Serial.print("Received ");
+  Serial.print(sizeof(data));
+  Serial.print(" B, other tasks meanwhile: ");
+  Serial.println(tasks);
+}
+
+void setup()
+{
+  Serial.begin(9600);
+  Serial.println("---");
+#if defined(GBJ_TWOWIRE_SIM)
+  SimBus.attach(&simDevice);
+#endif
+  if (device.isError(device.begin()))
+  {
+    errorHandler("Begin");
+    return;
+  }
+  if (device.isError(device.setAddress(ADDRESS_DEVICE)))
+  {
+    errorHandler("Address");
+    return;
+  }
+  device.setDelayReceive(DELAY_RECEIVE);
+}
+
+void loop()
+{
+  static byte cycle;
+  if (!device.isBusy() && cycle < CYCLES)
+  {
+    tasks = 0;
+    cycle++;
+    device.busReceiveAsync(data, sizeof(data), false, completionHandler);
+  }
+  // Other tasks run while the transfer waits for the receive delay
+  if (device.poll())
+  {
+    tasks++;
+  }
+}
@@ -0,0 +1,778 @@
+/*
+  NAME:
+  Benchmark of transfer methods of gbjTwoWire library.
+
+  DESCRIPTION:
+  The sketch measures every public transfer method at various payload sizes,
+  in both byte orders, and at both standard bus clock speeds.
+  * Throughput is the payload bytes per second of transfer time.
+  * Pages is the number of bus transactions a transfer has been split into
+    due to two-wire buffer length.
+  * Overhead is the share of wire time occupied by START, STOP, address, and
+    prefix bytes instead of payload.
+  * Cycles is the number of processor cycles per payload byte spent outside
+    of the wire time, i.e., in the library and the TwoWire implementation.
+  Streams from program memory compare with the ones from RAM.
+  Fixed frames compare the compile time transfer templates with the runtime
+  methods.
+  Cycles of register polling and of sensors with conversion times compare
+  single transfers with queued and scheduled ones. Writing of EEPROM pages
+  compares worst case write cycle delays with acknowledge polling, and pages
+  written one by one with a stream paged at the EEPROM page boundary. Paging
+  compares page lengths up to the buffer length and device page boundaries.
+  Loop cycles of a driver compare register accesses with the register cache.
+  Updates of a register bit compare reading and writing with read-modify-write.
+  On the simulated bus a page read is compared with one repeated after an
+  injected NACK and with one after recovery of the data line held low, and
+  a receive delay in microseconds stamped right before a millisecond tick is
+  waited in full.
+  Built with GBJ_TWOWIRE_STATS, transfer statistics of the sensors and the
+  EEPROM collected over the whole run are reported at the end.
+  On a microcontroller a device at ADDRESS_DEVICE acknowledging writes and
+  reads of any length is needed, e.g., a serial EEPROM, and the wire time is
+  calculated from the bus clock.
+  On a Linux host (see README) a virtual memory device is attached to the
+  simulated bus, which measures the wire time, while processor cycles are
+  counted by the host time stamp counter.
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#include "gbj_twowire.h"
+#if defined(GBJ_TWOWIRE_SIM)
+  #if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+  #else
+    #include <chrono>
+  #endif
+#endif
+
+const byte ADDRESS_DEVICE = 0x50;
+const byte COMMAND = 0x10;
+const byte REPEATS = 4;
+const byte REGISTERS = 6;
+const byte FRAME = 3;
+const byte SENSORS = 3;
+const byte ADDRESS_SENSOR = 0x51;
+const uint32_t DELAY_SENSOR = 5;
+const byte ADDRESS_EEPROM = 0x54;
+const byte EEPROM_WRITES = 8;
+const byte EEPROM_PAGE = 16;
+// Worst case write cycle time in milliseconds and typical one in microseconds
+const uint32_t EEPROM_CYCLE = 5;
+const uint32_t EEPROM_CYCLE_US = 3000;
+#if defined(__AVR__)
+const uint16_t BUFFER_SIZE = 256;
+#else
+const uint16_t BUFFER_SIZE = 4096;
+#endif
+const uint16_t SIZES[] = { 1, 2, 8, 31, 32, 33, 64, 256, 1024, 4096 };
+const uint16_t PAGING_SIZE = 256;
+const byte CACHE_CYCLES = 10;
+const byte UPDATE_CYCLES = 10;
+const byte RETRIES = 3;
+const uint16_t RETRY_BACKOFF_US = 20;
+const byte HELD_CLOCKS = 5;
+// Receive delay stamped the lead time before a millisecond tick
+const uint32_t DELAY_TICK_US = 300;
+const uint32_t DELAY_TICK_LEAD_US = 5;
+const uint8_t PAGE_LENGTHS[] = { 8, 16, BUFFER_LENGTH };
+
+enum Methods
+{
+  SEND_COMMAND,
+  SEND_COMMAND_DATA,
+  SEND_COMMAND_POLICY,
+  SEND_STREAM,
+  SEND_STREAM_P,
+  SEND_PREFIXED,
+  SEND_PREFIXED_ONETIME,
+  SEND_SEGMENTS,
+  RECEIVE,
+  RECEIVE_COMMAND,
+  RECEIVE_SEGMENTS,
+  SEND_FRAME,
+  SEND_FRAME_RUNTIME,
+  RECEIVE_FRAME,
+  RECEIVE_FRAME_RUNTIME,
+  METHODS,
+};
+const char *METHOD_NAMES[] = {
+  "busSend(cmd)",        "busSend(cmd,data)",  "busSend<P>(cmd,data)",
+  "busSendStream",       "busSendStream_P",    "busSendStreamPrfx",
+  "busSendStreamPrfx1x", "busSendSegments",    "busReceive",
+  "busReceive(cmd)",     "busReceiveSegments", "busSendStream<N>",
+  "busSendStream(N)",    "busReceive<N>",      "busReceive(N)",
+};
+
+struct Measurement
+{
+  uint32_t elapsedUs;
+  uint32_t wireBits;
+  uint32_t payloadBits;
+  uint32_t pages;
+  uint32_t cycles;
+};
+
+uint8_t buffer[BUFFER_SIZE];
+// Constant stream, e.g., a bitmap, kept in flash only
+const uint8_t flashBuffer[BUFFER_SIZE] PROGMEM = { 0 };
+uint8_t prefix[] = { COMMAND };
+// Display frame of a command, an address window, and pixels
+uint8_t window[] = { 0x00, 0x00, 0x7F, 0x3F };
+// Sensor reading of a header, samples, and a checksum
+uint8_t header[2];
+uint8_t checksum[1];
+gbj_twowire device = gbj_twowire();
+gbj_twowire::Device sensors[SENSORS];
+gbj_twowire::Device eeprom;
+
+#if defined(GBJ_TWOWIRE_SIM)
+uint8_t memory[BUFFER_SIZE + 256];
+gbj_twowire_sim_memory simDevice(ADDRESS_DEVICE, memory, sizeof(memory), 0);
+uint8_t registers[SENSORS][16];
+gbj_twowire_sim_memory simSensors[SENSORS] = {
+  { ADDRESS_SENSOR, registers[0], sizeof(registers[0]) },
+  { ADDRESS_SENSOR + 1, registers[1], sizeof(registers[1]) },
+  { ADDRESS_SENSOR + 2, registers[2], sizeof(registers[2]) },
+};
+uint8_t eepromMemory[EEPROM_WRITES * EEPROM_PAGE];
+gbj_twowire_sim_memory simEeprom(ADDRESS_EEPROM,
+                                 eepromMemory,
+                                 sizeof(eepromMemory),
+                                 2);
+
+uint32_t cycles()
+{
+  #if defined(__x86_64__) || defined(__i386__)
+  return static_cast<uint32_t>(__rdtsc());
+  #else
+  return static_cast<uint32_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch())
+      .count());
+  #endif
+}
+#else
+uint32_t cycles()
+{
+  return micros() * (F_CPU / 1000000L);
+}
+#endif
+
+uint16_t payloadLen(Methods method, uint16_t len)
+{
+  switch (method)
+  {
+    case SEND_COMMAND:
+      return 1;
+    case SEND_COMMAND_DATA:
+    case SEND_COMMAND_POLICY:
+      return 3;
+    case SEND_FRAME:
+    case SEND_FRAME_RUNTIME:
+    case RECEIVE_FRAME:
+    case RECEIVE_FRAME_RUNTIME:
+      return FRAME;
+    default:
+      return len;
+  }
+}
+
+gbj_twowire::ResultCodes transfer(Methods method, uint16_t len, bool reverse)
+{
+  switch (method)
+  {
+    case SEND_COMMAND:
+      return device.busSend(COMMAND);
+    case SEND_COMMAND_DATA:
+      return device.busSend(COMMAND, 0x1234);
+    case SEND_COMMAND_POLICY:
+      return device.busSend<gbj_twowire::StreamMsbVal>(COMMAND, 0x1234);
+    case SEND_STREAM:
+      return device.busSendStream(buffer, len, reverse);
+    case SEND_STREAM_P:
+      return device.busSendStream_P(flashBuffer, len, reverse);
+    case SEND_PREFIXED:
+      return device.busSendStreamPrefixed(
+        buffer, len, reverse, prefix, sizeof(prefix), false);
+    case SEND_PREFIXED_ONETIME:
+      return device.busSendStreamPrefixed(
+        buffer, len, reverse, prefix, sizeof(prefix), false, true);
+    case SEND_FRAME:
+      return reverse ? device.busSendStream<FRAME, true>(buffer)
+                     : device.busSendStream<FRAME>(buffer);
+    case SEND_FRAME_RUNTIME:
+      return device.busSendStream(buffer, FRAME, reverse);
+    case RECEIVE_FRAME:
+      return reverse ? device.busReceive<FRAME, true>(buffer)
+                     : device.busReceive<FRAME>(buffer);
+    case RECEIVE_FRAME_RUNTIME:
+      return device.busReceive(buffer, FRAME, reverse);
+    case SEND_SEGMENTS:
+    {
+      gbj_twowire::Segment segments[] = {
+        { prefix, sizeof(prefix), false, false, false },
+        { window, sizeof(window), false, false, false },
+        { buffer, len, reverse, false, false },
+      };
+      return device.busSendSegments(segments,
+                                    sizeof(segments) / sizeof(segments[0]));
+    }
+    case RECEIVE:
+      return device.busReceive(buffer, len, reverse);
+    case RECEIVE_SEGMENTS:
+    {
+      gbj_twowire::Segment segments[] = {
+        { header, sizeof(header), false, false, false },
+        { buffer, len, reverse, false, false },
+        { checksum, sizeof(checksum), false, false, false },
+      };
+      return device.busReceiveSegments(segments,
+                                       sizeof(segments) / sizeof(segments[0]));
+    }
+    case RECEIVE_COMMAND:
+    default:
+      return device.busReceive(COMMAND, buffer, len, reverse);
+  }
+}
+
+// Wire bits of transactions, which a method splits a transfer into, at
+// buffer length paging
+void calculateWire(Methods method, uint16_t len, Measurement &m)
+{
+  uint16_t pageLen = BUFFER_LENGTH;
+  uint32_t pages, bytes;
+  switch (method)
+  {
+    case SEND_PREFIXED:
+      pages = (len + pageLen - 2) / (pageLen - 1);
+      bytes = len + pages;
+      break;
+    case SEND_PREFIXED_ONETIME:
+      pages = 1 + (len > pageLen - 1 ? (len - pageLen) / pageLen + 1 : 0);
+      bytes = len + 1;
+      break;
+    case SEND_SEGMENTS:
+      bytes = len + sizeof(prefix) + sizeof(window);
+      pages = (bytes + pageLen - 1) / pageLen;
+      break;
+    case RECEIVE_SEGMENTS:
+      bytes = len + sizeof(header) + sizeof(checksum);
+      pages = (bytes + pageLen - 1) / pageLen;
+      break;
+    case RECEIVE_COMMAND:
+      pages = 1 + (len + pageLen - 1) / pageLen;
+      bytes = len + 1;
+      break;
+    default:
+      len = payloadLen(method, len);
+      pages = (len + pageLen - 1) / pageLen;
+      bytes = len;
+      break;
+  }
+  m.pages += pages;
+  // START and address byte per page, single STOP, 9 bits per byte with ACK
+  m.wireBits += pages * (1 + 9) + 1 + 9 * bytes;
+}
+
+bool measure(Methods method, uint16_t len, bool reverse, Measurement &m)
+{
+  m = Measurement();
+  // Untimed transfer warms up caches of the host
+  transfer(method, len, reverse);
+  for (byte i = 0; i < REPEATS; i++)
+  {
+#if defined(GBJ_TWOWIRE_SIM)
+    gbj_twowire_sim_bus::Statistics stats = SimBus.getStatistics();
+    uint64_t timestamp = SimBus.getNanos();
+    uint32_t cpu = cycles();
+    gbj_twowire::ResultCodes result = transfer(method, len, reverse);
+    m.cycles += cycles() - cpu;
+    const gbj_twowire_sim_bus::Statistics &now = SimBus.getStatistics();
+    m.elapsedUs += (SimBus.getNanos() - timestamp) / 1000;
+    m.pages += now.starts - stats.starts;
+    m.wireBits += 9 * (now.addressBytes - stats.addressBytes +
+                       now.bytesWritten - stats.bytesWritten +
+                       now.bytesRead - stats.bytesRead) +
+                  now.starts - stats.starts + now.stops - stats.stops;
+#else
+    uint32_t timestamp = micros();
+    gbj_twowire::ResultCodes result = transfer(method, len, reverse);
+    uint32_t elapsedUs = micros() - timestamp;
+    uint32_t wireBits = m.wireBits;
+    calculateWire(method, len, m);
+    uint32_t wireUs =
+      1000000ULL * (m.wireBits - wireBits) / device.getBusClock();
+    m.elapsedUs += elapsedUs;
+    m.cycles += (elapsedUs > wireUs ? elapsedUs - wireUs : 0) *
+                (F_CPU / 1000000L);
+#endif
+    m.payloadBits += 9 * payloadLen(method, len);
+    if (device.isError(result))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void report(Methods method, uint16_t len, bool reverse)
+{
+  Measurement m;
+  if (!measure(method, len, reverse, m))
+  {
+    Serial.println(device.getLastErrorTxt(METHOD_NAMES[method]));
+    return;
+  }
+  uint32_t bytes = static_cast<uint32_t>(REPEATS) * payloadLen(method, len);
+  Serial.print(METHOD_NAMES[method]);
+  Serial.print("\t");
+  Serial.print(device.getBusClock() / 1000);
+  Serial.print(" kHz\t");
+  Serial.print(reverse ? "REV" : "FWD");
+  Serial.print("\t");
+  Serial.print(payloadLen(method, len));
+  Serial.print(" B\t");
+  Serial.print(
+    static_cast<uint32_t>(m.elapsedUs ? 1000000ULL * bytes / m.elapsedUs : 0));
+  Serial.print(" B/s\t");
+  Serial.print(m.pages / REPEATS);
+  Serial.print(" pg\t");
+  Serial.print(100.0 * (m.wireBits - m.payloadBits) / m.wireBits, 1);
+  Serial.print(" %ovh\t");
+  Serial.print(m.cycles / bytes);
+  Serial.println(" cyc/B");
+}
+
+// Polling cycle reading several 2-byte registers one by one or by a queue
+void reportPolling()
+{
+  const byte registers = REGISTERS;
+  uint8_t pointers[registers];
+  uint8_t values[registers][2];
+  gbj_twowire::Transfer queue[2 * registers];
+  for (byte r = 0; r < registers; r++)
+  {
+    pointers[r] = COMMAND + 2 * r;
+    queue[2 * r] = { ADDRESS_DEVICE,
+                     gbj_twowire::TRANSFER_SEND,
+                     &pointers[r],
+                     1,
+                     gbj_twowire::SUCCESS };
+    queue[2 * r + 1] = { ADDRESS_DEVICE,
+                         gbj_twowire::TRANSFER_RECEIVE,
+                         values[r],
+                         2,
+                         gbj_twowire::SUCCESS };
+  }
+  uint32_t timestamp = micros();
+  for (byte r = 0; r < registers; r++)
+  {
+    device.busReceive(pointers[r], values[r], 2);
+  }
+  uint32_t singleUs = micros() - timestamp;
+  timestamp = micros();
+  device.busExecute(queue, 2 * registers);
+  uint32_t queueUs = micros() - timestamp;
+  Serial.print("Polling ");
+  Serial.print(registers);
+  Serial.print(" registers\t");
+  Serial.print(device.getBusClock() / 1000);
+  Serial.print(" kHz\tbusReceive ");
+  Serial.print(singleUs);
+  Serial.print(" us\tbusExecute ");
+  Serial.print(queueUs);
+  Serial.println(" us");
+}
+
+// Measurement cycle of several sensors, each one starting a conversion by a
+// command and being read after its conversion time, one by one, by a queue,
+// and by the scheduler interleaving the conversions
+void reportScheduling()
+{
+  uint8_t commands[SENSORS];
+  uint8_t values[SENSORS][2];
+  gbj_twowire::Transfer queue[2 * SENSORS];
+  for (byte s = 0; s < SENSORS; s++)
+  {
+    commands[s] = COMMAND;
+    queue[2 * s] = { sensors[s].address,
+                     gbj_twowire::TRANSFER_SEND,
+                     &commands[s],
+                     1,
+                     gbj_twowire::SUCCESS };
+    queue[2 * s + 1] = { sensors[s].address,
+                         gbj_twowire::TRANSFER_RECEIVE,
+                         values[s],
+                         2,
+                         gbj_twowire::SUCCESS };
+  }
+  uint32_t timestamp = micros();
+  for (byte s = 0; s < SENSORS; s++)
+  {
+    device.selectDevice(sensors[s]);
+    device.busSend(commands[s]);
+    device.busReceive(values[s], 2);
+  }
+  device.selectDevice();
+  uint32_t singleUs = micros() - timestamp;
+  timestamp = micros();
+  device.busExecute(queue, 2 * SENSORS);
+  uint32_t queueUs = micros() - timestamp;
+  timestamp = micros();
+  device.busSchedule(queue, 2 * SENSORS);
+  uint32_t scheduleUs = micros() - timestamp;
+  Serial.print("Sensors ");
+  Serial.print(SENSORS);
+  Serial.print("\t");
+  Serial.print(device.getBusClock() / 1000);
+  Serial.print(" kHz\tbusReceive ");
+  Serial.print(singleUs);
+  Serial.print(" us\tbusExecute ");
+  Serial.print(queueUs);
+  Serial.print(" us\tbusSchedule ");
+  Serial.print(scheduleUs);
+  Serial.println(" us");
+}
+
+// Writing of several EEPROM pages, each one awaiting the write cycle of the
+// previous one by the worst case delay or by acknowledge polling
+uint32_t measureEeprom()
+{
+  uint8_t page[2 + EEPROM_PAGE];
+  uint32_t timestamp = micros();
+  device.selectDevice(eeprom);
+  for (byte w = 0; w < EEPROM_WRITES; w++)
+  {
+    page[0] = 0;
+    page[1] = w * EEPROM_PAGE;
+    device.busSendStream(page, sizeof(page));
+  }
+  // Wait for the last write cycle
+  device.busReceive(page, 1);
+  device.selectDevice();
+  return micros() - timestamp;
+}
+
+// Writing of the same EEPROM pages as one stream split at page boundaries
+// with the word address of every page
+uint32_t measureEepromPaged()
+{
+  uint8_t page[EEPROM_WRITES * EEPROM_PAGE];
+  uint32_t timestamp = micros();
+  device.selectDevice(eeprom);
+  device.setPageBoundary(EEPROM_PAGE, 0, 2);
+  device.busSendStream(page, sizeof(page));
+  device.busReceive(page, 1);
+  device.setPageBoundary(0);
+  device.selectDevice();
+  return micros() - timestamp;
+}
+
+void reportAckPolling()
+{
+  eeprom.sendDelay = eeprom.receiveDelay = EEPROM_CYCLE;
+  eeprom.ackTimeout = 0;
+  uint32_t delayUs = measureEeprom();
+  eeprom.sendDelay = eeprom.receiveDelay = 0;
+  eeprom.ackTimeout = 2 * EEPROM_CYCLE;
+  uint32_t pollingUs = measureEeprom();
+  uint32_t pagedUs = measureEepromPaged();
+  Serial.print("EEPROM ");
+  Serial.print(EEPROM_WRITES);
+  Serial.print(" writes\t");
+  Serial.print(device.getBusClock() / 1000);
+  Serial.print(" kHz\tdelay ");
+  Serial.print(delayUs);
+  Serial.print(" us\tack polling ");
+  Serial.print(pollingUs);
+  Serial.print(" us\tpaged ");
+  Serial.print(pagedUs);
+  Serial.println(" us");
+}
+
+// Sending of a stream split into pages of various lengths and on device page
+// boundaries
+uint32_t measurePaging(uint8_t pageLength, uint16_t pageBoundary)
+{
+  uint16_t len = BUFFER_SIZE < PAGING_SIZE ? BUFFER_SIZE : PAGING_SIZE;
+  device.setPageLength(pageLength);
+  device.setPageBoundary(pageBoundary, pageBoundary / 2);
+  uint32_t timestamp = micros();
+  device.busSendStream(buffer, len);
+  uint32_t elapsedUs = micros() - timestamp;
+  device.setPageLength(0);
+  device.setPageBoundary(0);
+  return elapsedUs;
+}
+
+void reportPaging()
+{
+  Serial.print("Paging ");
+  Serial.print(BUFFER_SIZE < PAGING_SIZE ? BUFFER_SIZE : PAGING_SIZE);
+  Serial.print(" B\t");
+  Serial.print(device.getBusClock() / 1000);
+  Serial.print(" kHz");
+  for (byte p = 0; p < sizeof(PAGE_LENGTHS) / sizeof(PAGE_LENGTHS[0]); p++)
+  {
+    Serial.print("\tpage ");
+    Serial.print(PAGE_LENGTHS[p]);
+    Serial.print(" ");
+    Serial.print(measurePaging(PAGE_LENGTHS[p], 0));
+    Serial.print(" us");
+  }
+  Serial.print("\tboundary ");
+  Serial.print(EEPROM_PAGE);
+  Serial.print(" ");
+  Serial.print(measurePaging(0, EEPROM_PAGE));
+  Serial.println(" us");
+}
+
+// Loop cycles of a driver rewriting its configuration register and reading
+// a static identification register, without and with register cache
+uint32_t measureCaching()
+{
+  uint8_t id[2];
+  uint32_t timestamp = micros();
+  for (byte c = 0; c < CACHE_CYCLES; c++)
+  {
+    device.busSend(COMMAND, 0x1234);
+    device.busReceive(COMMAND + 2, id, sizeof(id));
+  }
+  return micros() - timestamp;
+}
+
+void reportCaching()
+{
+  gbj_twowire::Register registers[] = {
+    { COMMAND, 0, 0 },
+    { COMMAND + 2, 0, gbj_twowire::REGISTER_CACHEABLE },
+  };
+  uint32_t busUs = measureCaching();
+  device.setRegisterCache(registers,
+                          sizeof(registers) / sizeof(registers[0]));
+  uint32_t cacheUs = measureCaching();
+  device.setRegisterCache(nullptr, 0);
+  Serial.print("Registers ");
+  Serial.print(CACHE_CYCLES);
+  Serial.print(" cycles\t");
+  Serial.print(device.getBusClock() / 1000);
+  Serial.print(" kHz\tbus ");
+  Serial.print(busUs);
+  Serial.print(" us\tcache ");
+  Serial.print(cacheUs);
+  Serial.println(" us");
+}
+
+// Updates of a bit in a register of a sensor with conversion time by a
+// reading and a writing, and by read-modify-write
+void reportUpdate()
+{
+  uint8_t value[1];
+  device.selectDevice(sensors[0]);
+  uint32_t timestamp = micros();
+  for (byte c = 0; c < UPDATE_CYCLES; c++)
+  {
+    device.busReceive(COMMAND, value, sizeof(value));
+    device.busSend(COMMAND, value[0] ^ 0x01);
+  }
+  uint32_t singleUs = micros() - timestamp;
+  timestamp = micros();
+  for (byte c = 0; c < UPDATE_CYCLES; c++)
+  {
+    device.busUpdate(COMMAND, 0x01, c);
+  }
+  uint32_t updateUs = micros() - timestamp;
+  device.selectDevice();
+  Serial.print("Updates ");
+  Serial.print(UPDATE_CYCLES);
+  Serial.print("\t");
+  Serial.print(device.getBusClock() / 1000);
+  Serial.print(" kHz\tbusReceive+busSend ");
+  Serial.print(singleUs);
+  Serial.print(" us\tbusUpdate ");
+  Serial.print(updateUs);
+  Serial.println(" us");
+}
+
+#if defined(GBJ_TWOWIRE_SIM)
+void reportRecovery()
+{
+  uint8_t data[BUFFER_LENGTH];
+  device.setRetries(RETRIES, RETRY_BACKOFF_US);
+  uint32_t timestamp = micros();
+  device.busReceive(data, sizeof(data));
+  uint32_t cleanUs = micros() - timestamp;
+  SimBus.injectNacks(1);
+  timestamp = micros();
+  device.busReceive(data, sizeof(data));
+  uint32_t retryUs = micros() - timestamp;
+  SimBus.injectHeldSDA(HELD_CLOCKS);
+  timestamp = micros();
+  device.busReceive(data, sizeof(data));
+  uint32_t recoveryUs = micros() - timestamp;
+  device.setRetries(0);
+  Serial.print("Recovery ");
+  Serial.print(sizeof(data));
+  Serial.print(" B\t");
+  Serial.print(device.getBusClock() / 1000);
+  Serial.print(" kHz\tclean ");
+  Serial.print(cleanUs);
+  Serial.print(" us\tNACK retried ");
+  Serial.print(retryUs);
+  Serial.print(" us\tSDA held recovered ");
+  Serial.print(recoveryUs);
+  Serial.println(" us");
+}
+
+void reportDelayTick()
+{
+  uint8_t data[1];
+  // Delays pending from previous transfers awaited before the measurement
+  device.busReceive(data, sizeof(data));
+  uint64_t timestamp = SimBus.getNanos();
+  device.busReceive(data, sizeof(data));
+  uint64_t cleanNs = SimBus.getNanos() - timestamp;
+  // Stamped by a receive ending the lead time before the tick
+  SimBus.advance(
+    1000000 -
+    (SimBus.getNanos() + cleanNs + 1000 * DELAY_TICK_LEAD_US) % 1000000);
+  device.busReceive(data, sizeof(data));
+  device.setDelayReceiveUs(DELAY_TICK_US);
+  uint64_t busNanos = SimBus.getStatistics().busNanos;
+  timestamp = SimBus.getNanos();
+  device.busReceive(data, sizeof(data));
+  // Time off the bus since the stamp
+  busNanos = SimBus.getStatistics().busNanos - busNanos;
+  uint32_t waitUs = (SimBus.getNanos() - timestamp - busNanos + 500) / 1000;
+  device.setDelayReceiveUs(0);
+  Serial.print("Delay ");
+  Serial.print(DELAY_TICK_US);
+  Serial.print(" us\tstamped ");
+  Serial.print(DELAY_TICK_LEAD_US);
+  Serial.print(" us before ms tick\twaited ");
+  Serial.print(waitUs);
+  // Within the resolution of the microsecond timestamp
+  Serial.println(waitUs + 1 < DELAY_TICK_US ? " us\tFAIL" : " us\tOK");
+}
+#endif
+
+#if defined(GBJ_TWOWIRE_STATS)
+void reportStatistics(const char *name, gbj_twowire::Device &target)
+{
+  device.selectDevice(target);
+  const gbj_twowire::Statistics &stats = device.getStatistics();
+  Serial.print(name);
+  Serial.print(" 0x");
+  Serial.print(target.address, HEX);
+  Serial.print("\ttransactions ");
+  Serial.print(stats.transactions);
+  Serial.print("\tfailed ");
+  Serial.print(stats.transactions - device.getResultCount(device.SUCCESS));
+  Serial.print("\tpages ");
+  Serial.print(stats.pages);
+  Serial.print("\trepeated starts ");
+  Serial.print(stats.repeatedStarts);
+  Serial.print("\tsent ");
+  Serial.print(stats.bytesSent);
+  Serial.print(" B\treceived ");
+  Serial.print(stats.bytesReceived);
+  Serial.print(" B\twaiting ");
+  Serial.print(stats.waitUs / 1000);
+  Serial.print(" ms\thistogram");
+  for (byte b = 0; b < GBJ_TWOWIRE_STATS_BUCKETS; b++)
+  {
+    Serial.print(" ");
+    Serial.print(stats.histogram[b]);
+  }
+  Serial.println();
+  device.selectDevice();
+}
+#endif
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("---");
+#if defined(GBJ_TWOWIRE_SIM)
+  SimBus.attach(&simDevice);
+  for (byte s = 0; s < SENSORS; s++)
+  {
+    SimBus.attach(&simSensors[s]);
+  }
+  simEeprom.setWriteCycle(EEPROM_CYCLE_US);
+  simEeprom.setWritePage(EEPROM_PAGE);
+  SimBus.attach(&simEeprom);
+#endif
+  for (uint16_t i = 0; i < BUFFER_SIZE; i++)
+  {
+    buffer[i] = i;
+  }
+  // Sensors with different conversion times
+  for (byte s = 0; s < SENSORS; s++)
+  {
+    sensors[s].address = ADDRESS_SENSOR + s;
+    sensors[s].receiveDelay = DELAY_SENSOR * (s + 1);
+    device.attachDevice(sensors[s]);
+  }
+  eeprom.address = ADDRESS_EEPROM;
+  if (device.isError(device.begin()) ||
+      device.isError(device.setAddress(ADDRESS_DEVICE)))
+  {
+    Serial.println(device.getLastErrorTxt("Begin"));
+    return;
+  }
+  const gbj_twowire::ClockSpeeds clocks[] = {
+    gbj_twowire::CLOCK_100KHZ,
+    gbj_twowire::CLOCK_400KHZ,
+  };
+  for (byte c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+  {
+    device.setBusClock(clocks[c]);
+    reportPolling();
+    reportScheduling();
+    reportAckPolling();
+    reportPaging();
+    reportCaching();
+    reportUpdate();
+#if defined(GBJ_TWOWIRE_SIM)
+    reportRecovery();
+    reportDelayTick();
+#endif
+    report(SEND_COMMAND, 0, false);
+    report(SEND_COMMAND_DATA, 0, false);
+    report(SEND_COMMAND_POLICY, 0, false);
+    for (byte m = SEND_FRAME; m < METHODS; m++)
+    {
+      report(static_cast<Methods>(m), 0, false);
+      report(static_cast<Methods>(m), 0, device.REVERSE);
+    }
+    for (byte m = SEND_STREAM; m <= RECEIVE_SEGMENTS; m++)
+    {
+      for (byte s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++)
+      {
+        if (SIZES[s] > BUFFER_SIZE)
+        {
+          continue;
+        }
+        report(static_cast<Methods>(m), SIZES[s], false);
+        report(static_cast<Methods>(m), SIZES[s], device.REVERSE);
+      }
+    }
+  }
+#if defined(GBJ_TWOWIRE_STATS)
+  for (byte s = 0; s < SENSORS; s++)
+  {
+    reportStatistics("Sensor", sensors[s]);
+  }
+  reportStatistics("EEPROM", eeprom);
+#endif
+  Serial.println("---");
+}
+
+void loop() {}
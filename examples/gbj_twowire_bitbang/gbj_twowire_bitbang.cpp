@@ -0,0 +1,168 @@
+/*
+  NAME:
+  Throughput of the bit-banged transport of gbjTwoWire library.
+
+  DESCRIPTION:
+  The sketch writes a block of data to a device and reads it back through the
+  software transport gbj_twowire_bitbang on the pins of the driver at the bus
+  clock of Standard-mode, Fast-mode, and Fast-mode Plus, and reports the
+  throughput of the payload and its verification.
+  * The whole build has to define the macro GBJ_TWOWIRE_TRANSPORT as
+    gbj_twowire_bitbang, e.g., by a build flag (see README).
+  * On a microcontroller a device at ADDRESS_DEVICE acknowledging writes and
+    reads of any length is needed, e.g., a serial EEPROM, with pull-up
+    resistors on both lines.
+  * On a Linux host (see README) a virtual memory device is attached to the
+    simulated bus, which decodes the waveform of the GPIO driven lines. The
+    effective clock and minimal timing parameters of the waveform are
+    compared with the limits of the bus specification for the mode. The
+    transfers are repeated with the clock line stretched by the device after
+    every byte.
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#if !defined(GBJ_TWOWIRE_TRANSPORT)
+  #error "Build with GBJ_TWOWIRE_TRANSPORT=gbj_twowire_bitbang"
+#endif
+#include "gbj_twowire.h"
+
+const byte ADDRESS_DEVICE = 0x50;
+const byte PIN_SDA = 4;
+const byte PIN_SCL = 5;
+const uint16_t BLOCK = 256;
+const uint32_t STRETCH_NS = 2000;
+
+// Minimal timing parameters of the bus modes in nanoseconds
+struct Limits
+{
+  const char *mode;
+  uint16_t low, high, startHold, startSetup, stopSetup, busFree, dataSetup;
+};
+const Limits LIMITS[] = {
+  { "Sm", 4700, 4000, 4000, 4700, 4000, 4700, 250 },
+  { "Fm", 1300, 600, 600, 600, 600, 1300, 100 },
+  { "Fm+", 500, 260, 260, 260, 260, 500, 50 },
+};
+const gbj_twowire::ClockSpeeds CLOCKS[] = {
+  gbj_twowire::CLOCK_100KHZ,
+  gbj_twowire::CLOCK_400KHZ,
+  gbj_twowire::CLOCK_1MHZ,
+};
+
+uint8_t block[BLOCK];
+uint8_t readBack[BLOCK];
+gbj_twowire device =
+  gbj_twowire(gbj_twowire::CLOCK_100KHZ, PIN_SDA, PIN_SCL);
+
+#if defined(GBJ_TWOWIRE_SIM)
+uint8_t memory[BLOCK];
+gbj_twowire_sim_memory simDevice(ADDRESS_DEVICE, memory, sizeof(memory), 0);
+
+void reportWaveform(const Limits &limits)
+{
+  const gbj_twowire_sim_bus::Waveform &wave = SimBus.getWaveform();
+  bool valid = wave.lowNanos >= limits.low && wave.highNanos >= limits.high &&
+               wave.startHoldNanos >= limits.startHold &&
+               (wave.startSetupNanos == 0xFFFFFFFF ||
+                wave.startSetupNanos >= limits.startSetup) &&
+               wave.stopSetupNanos >= limits.stopSetup &&
+               wave.busFreeNanos >= limits.busFree &&
+               wave.dataSetupNanos >= limits.dataSetup;
+  Serial.print("\tSCL ");
+  Serial.print(1000000UL / wave.periodNanos);
+  Serial.print(" kHz\ttLOW ");
+  Serial.print(wave.lowNanos);
+  Serial.print(" ns\ttHIGH ");
+  Serial.print(wave.highNanos);
+  Serial.print(" ns\ttBUF ");
+  Serial.print(wave.busFreeNanos);
+  Serial.print(" ns\t");
+  Serial.print(limits.mode);
+  Serial.print(valid ? " timing OK" : " timing VIOLATED");
+  if (wave.stretchNanos)
+  {
+    Serial.print("\tstretched ");
+    Serial.print(static_cast<uint32_t>(wave.stretchNanos / 1000));
+    Serial.print(" us");
+  }
+}
+#endif
+
+void report(byte clock, bool stretch)
+{
+  device.setBusClock(CLOCKS[clock]);
+#if defined(GBJ_TWOWIRE_SIM)
+  // Rewind the stream device
+  simDevice = gbj_twowire_sim_memory(
+    ADDRESS_DEVICE, memory, sizeof(memory), 0);
+  SimBus.setStretch(stretch ? STRETCH_NS : 0);
+  SimBus.resetWaveform();
+#endif
+  uint32_t timestamp = micros();
+  if (device.isError(device.busSendStream(block, BLOCK)))
+  {
+    Serial.println(device.getLastErrorTxt("Send"));
+    return;
+  }
+#if defined(GBJ_TWOWIRE_SIM)
+  simDevice = gbj_twowire_sim_memory(
+    ADDRESS_DEVICE, memory, sizeof(memory), 0);
+#endif
+  if (device.isError(device.busReceive(readBack, BLOCK)))
+  {
+    Serial.println(device.getLastErrorTxt("Receive"));
+    return;
+  }
+  uint32_t elapsedUs = micros() - timestamp;
+  Serial.print(CLOCKS[clock] / 1000);
+  Serial.print(" kHz\t");
+  Serial.print(2 * BLOCK);
+  Serial.print(" B\t");
+  Serial.print(2000000UL * BLOCK / elapsedUs);
+  Serial.print(" B/s\t");
+  Serial.print(memcmp(block, readBack, BLOCK) ? "corrupted" : "verified");
+#if defined(GBJ_TWOWIRE_SIM)
+  reportWaveform(LIMITS[clock]);
+#else
+  (void)stretch;
+#endif
+  Serial.println();
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("---");
+#if defined(GBJ_TWOWIRE_SIM)
+  SimBus.attach(&simDevice);
+#endif
+  for (uint16_t i = 0; i < BLOCK; i++)
+  {
+    block[i] = i ^ 0xA5;
+  }
+  if (device.isError(device.begin()) ||
+      device.isError(device.setAddress(ADDRESS_DEVICE)))
+  {
+    Serial.println(device.getLastErrorTxt("Begin"));
+    return;
+  }
+  for (byte c = 0; c < sizeof(CLOCKS) / sizeof(CLOCKS[0]); c++)
+  {
+    report(c, false);
+  }
+#if defined(GBJ_TWOWIRE_SIM)
+  Serial.println("Clock stretching");
+  for (byte c = 0; c < sizeof(CLOCKS) / sizeof(CLOCKS[0]); c++)
+  {
+    report(c, true);
+  }
+#endif
+  Serial.println("---");
+}
+
+void loop() {}
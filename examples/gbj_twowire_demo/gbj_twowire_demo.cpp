@@ -4,6 +4,8 @@
 
   DESCRIPTION:
   The sketch sets address of a device and checks if it is correct.
+  Errors are reported without heap allocation, built with GBJ_TWOWIRE_ERRORS
+  the error log is listed as well.
 
   LICENSE:
   This program is free software; you can redistribute it and/or modify
@@ -22,9 +24,18 @@ gbj_twowire device = gbj_twowire();
 // gbj_twowire device = gbj_twowire(device.CLOCK_100KHZ);
 // gbj_twowire device = gbj_twowire(device.CLOCK_100KHZ, D2, D1);
 
-void errorHandler(String location)
+void errorHandler(const char *location)
 {
-  Serial.println(device.getLastErrorTxt(location));
+  char text[64];
+  device.getLastErrorTxt(text, sizeof(text), location);
+  Serial.println(text);
+#if defined(GBJ_TWOWIRE_ERRORS)
+  for (byte i = 0; i < device.getErrorEvents(); i++)
+  {
+    device.getErrorEventTxt(text, sizeof(text), *device.getErrorEvent(i));
+    Serial.println(text);
+  }
+#endif
   Serial.println("---");
 }
 
@@ -0,0 +1,97 @@
+/*
+  NAME:
+  Bus scanning of gbjTwoWire library.
+
+  DESCRIPTION:
+  The sketch scans the bus for present devices within a time budget per loop
+  cycle, so that the loop keeps running meanwhile, and identifies known chips
+  by their identification registers.
+  * On a microcontroller any devices on the bus are found.
+  * On a Linux host (see README) virtual devices imitating a light sensor,
+    an EEPROM, an accelerometer, and a pressure sensor are attached to the
+    simulated bus.
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#include "gbj_twowire.h"
+
+const uint32_t SCAN_BUDGET = 1;
+
+// Known chips with identification registers
+const gbj_twowire::Fingerprint FINGERPRINTS[] = {
+  { 0x68, 0x69, 0x75, 0x7E, 0x68 }, // MPU6050
+  { 0x76, 0x77, 0xD0, 0xFF, 0x58 }, // BMP280
+  { 0x76, 0x77, 0xD0, 0xFF, 0x60 }, // BME280
+};
+const char *NAMES[] = { "MPU6050", "BMP280", "BME280", "unknown" };
+const byte CHIPS = sizeof(FINGERPRINTS) / sizeof(FINGERPRINTS[0]);
+
+uint8_t bitmap[16];
+uint32_t cycles;
+gbj_twowire device = gbj_twowire();
+
+#if defined(GBJ_TWOWIRE_SIM)
+uint8_t lightMemory[2], eepromMemory[256], imuMemory[256], baroMemory[256];
+gbj_twowire_sim_memory simLight(0x23, lightMemory, sizeof(lightMemory), 0);
+gbj_twowire_sim_memory simEeprom(0x50, eepromMemory, sizeof(eepromMemory));
+gbj_twowire_sim_memory simImu(0x68, imuMemory, sizeof(imuMemory));
+gbj_twowire_sim_memory simBaro(0x76, baroMemory, sizeof(baroMemory));
+#endif
+
+void setup()
+{
+  Serial.begin(9600);
+  Serial.println("---");
+#if defined(GBJ_TWOWIRE_SIM)
+  imuMemory[0x75] = 0x68;
+  baroMemory[0xD0] = 0x60;
+  SimBus.attach(&simLight);
+  SimBus.attach(&simEeprom);
+  SimBus.attach(&simImu);
+  SimBus.attach(&simBaro);
+#endif
+  if (device.isError(device.begin()))
+  {
+    Serial.println(device.getLastErrorTxt("Begin"));
+  }
+}
+
+void loop()
+{
+  static bool scanned;
+  if (scanned)
+  {
+    return;
+  }
+  // Other tasks run between parts of the scan
+  cycles++;
+  if (device.busScan(bitmap, device.SCAN_AUTO, SCAN_BUDGET) ==
+      device.ERROR_PENDING)
+  {
+    return;
+  }
+  scanned = true;
+  Serial.print("Scanned in ");
+  Serial.print(millis());
+  Serial.print(" ms, loop cycles: ");
+  Serial.println(cycles);
+  for (uint8_t address = device.getAddressMinUsual();
+       address <= device.getAddressMaxUsual();
+       address++)
+  {
+    if (device.isScanned(bitmap, address))
+    {
+      Serial.print("0x");
+      Serial.print(address, HEX);
+      Serial.print(": ");
+      Serial.println(
+        NAMES[device.busIdentify(address, FINGERPRINTS, CHIPS)]);
+    }
+  }
+  Serial.println("---");
+}
@@ -0,0 +1,99 @@
+/*
+  NAME:
+  Streaming transfers of gbjTwoWire library.
+
+  DESCRIPTION:
+  The sketch sends a data stream larger than available memory to a device,
+  producing it page by page by a source function, and reads it back page by
+  page into a sink function, which prints its checksum, so that only a page
+  of the stream is ever buffered.
+  * On a microcontroller a device at ADDRESS_DEVICE acknowledging writes and
+    reads of any length is needed, e.g., a serial EEPROM.
+  * On a Linux host (see README) a virtual memory device is attached to the
+    simulated bus.
+
+  LICENSE:
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the MIT License (MIT).
+
+  CREDENTIALS:
+  Author: Libor Gabaj
+*/
+#include "gbj_twowire.h"
+
+const byte ADDRESS_DEVICE = 0x50;
+const uint32_t STREAM_LEN = 8192;
+
+uint16_t checksum;
+gbj_twowire device = gbj_twowire();
+
+#if defined(GBJ_TWOWIRE_SIM)
+uint8_t memory[STREAM_LEN];
+gbj_twowire_sim_memory simDevice(ADDRESS_DEVICE, memory, sizeof(memory), 0);
+#endif
+
+void errorHandler(String location)
+{
+  Serial.println(device.getLastErrorTxt(location));
+  Serial.println("---");
+}
+
+// Stream pattern computed instead of stored
+bool source(uint8_t *pageBuffer, uint8_t pageLen, uint32_t offset)
+{
+  for (uint8_t i = 0; i < pageLen; i++)
+  {
+    pageBuffer[i] = (offset + i) ^ ((offset + i) >> 8);
+  }
+  return true;
+}
+
+bool sink(const uint8_t *pageBuffer, uint8_t pageLen, uint32_t)
+{
+  for (uint8_t i = 0; i < pageLen; i++)
+  {
+    checksum += pageBuffer[i];
+  }
+  return true;
+}
+
+void setup()
+{
+  Serial.begin(9600);
+  Serial.println("---");
+#if defined(GBJ_TWOWIRE_SIM)
+  SimBus.attach(&simDevice);
+#endif
+  if (device.isError(device.begin()))
+  {
+    errorHandler("Begin");
+    return;
+  }
+  if (device.isError(device.setAddress(ADDRESS_DEVICE)))
+  {
+    errorHandler("Address");
+    return;
+  }
+  if (device.isError(device.busSendStream(source, STREAM_LEN)))
+  {
+    errorHandler("Send");
+    return;
+  }
+#if defined(GBJ_TWOWIRE_SIM)
+  // Rewind the stream device
+  simDevice = gbj_twowire_sim_memory(
+    ADDRESS_DEVICE, memory, sizeof(memory), 0);
+#endif
+  if (device.isError(device.busReceive(sink, STREAM_LEN)))
+  {
+    errorHandler("Receive");
+    return;
+  }
+  Serial.print("Streamed ");
+  Serial.print(STREAM_LEN);
+  Serial.print(" B, checksum: 0x");
+  Serial.println(checksum, HEX);
+  Serial.println("---");
+}
+
+void loop() {}
@@ -4,44 +4,72 @@ gbj_twowire::ResultCodes gbj_twowire::busSendStream(uint8_t *dataBuffer,
                                                     uint16_t dataLen,
                                                     bool dataReverse)
 {
-  bool origBusStop = getBusStop();
+  StatsScope stats(*this);
   setLastResult();
-  setBusRepeat();
-  if (dataReverse)
+  waitTimestampSend();
+  if (setLastResult(waitAck(getDevice())) ||
+      setLastResult(
+        sendPages(getDevice(), dataBuffer, dataLen, dataReverse, getBusStop())))
   {
-    dataBuffer += dataLen;
-    dataBuffer--;
+    return getLastResult();
   }
+  stampDevice(getDevice(), isPageStop(getDevice(), true, getBusStop()));
+  return getLastResult();
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busSendStream_P(const uint8_t *dataBuffer,
+                                                      uint16_t dataLen,
+                                                      bool dataReverse)
+{
+  Segment segments[] = {
+    { const_cast<uint8_t *>(dataBuffer), dataLen, dataReverse, false, true },
+  };
+  return busSendSegments(segments, sizeof(segments) / sizeof(segments[0]));
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busSendStream(StreamSource source,
+                                                    uint32_t dataLen)
+{
+  StatsScope stats(*this);
+  uint8_t pageBuffer[DataStreamProcessing::STREAM_BUFFER_LENGTH];
+  uint32_t offset = 0;
+  setLastResult();
   waitTimestampSend();
-  while (dataLen)
+  if (setLastResult(waitAck(getDevice())))
   {
-    uint8_t pageLen = DataStreamProcessing::STREAM_BUFFER_LENGTH;
-    beginTransmission(getAddress());
-    while (pageLen > 0 && dataLen > 0)
+    return getLastResult();
+  }
+  while (offset < dataLen)
+  {
+    uint8_t pageLen =
+      getPageLen(getDevice(), dataLen - offset, getDevice().positionBytes);
+    if (!source(pageBuffer, pageLen, offset))
     {
-      if (dataReverse)
+      if (offset)
       {
-        write(*dataBuffer--);
+        releaseBus(getAddress());
       }
-      else
-      {
-        write(*dataBuffer++);
-      }
-      pageLen--;
-      dataLen--;
+      return setLastResult(ResultCodes::ERROR_ABORTED);
     }
-    // Return original flag at last page
-    if (dataLen == 0)
+    offset += pageLen;
+    bool pageStop = isPageStop(getDevice(), offset >= dataLen, getBusStop());
+    statPage(getDevice(), pageLen, true, pageStop);
+    ResultCodes result;
+    uint8_t attempt = 0;
+    do
     {
-      setBusStopFlag(origBusStop);
-    }
-    if (setLastResult(static_cast<ResultCodes>(endTransmission(getBusStop()))))
+      beginPage(getDevice());
+      write(pageBuffer, pageLen);
+      result = static_cast<ResultCodes>(endTransmission(pageStop));
+    } while (isError(result) && retryPage(getDevice(), result, attempt++));
+    getDevice().pagePosition += pageLen;
+    if (setLastResult(result) ||
+        (offset < dataLen && setLastResult(waitPage(getDevice()))))
     {
       return getLastResult();
     }
   }
-  setTimestamp();
-  setBusStopFlag(origBusStop);
+  stampDevice(getDevice(), isPageStop(getDevice(), true, getBusStop()));
   return getLastResult();
 }
 
@@ -53,240 +81,1388 @@ gbj_twowire::ResultCodes gbj_twowire::busSendStreamPrefixed(uint8_t *dataBuffer,
                                                             bool prfxReverse,
                                                             bool prfxOnetime)
 {
-  bool origBusStop = getBusStop();
-  bool prfxExec = true;
-  setLastResult();
-  setBusRepeat();
-  if (dataReverse)
+  // Prefix alone is not sent, since a device could take it as a command
+  if (dataLen == 0)
   {
-    dataBuffer += dataLen;
-    dataBuffer--;
+    return setLastResult();
   }
-  if (prfxReverse)
+  Segment segments[] = {
+    { prfxBuffer, prfxLen, prfxReverse, !prfxOnetime, false },
+    { dataBuffer, dataLen, dataReverse, false, false },
+  };
+  return busSendSegments(segments, sizeof(segments) / sizeof(segments[0]));
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busSendStreamPrefixed_P(
+  const uint8_t *dataBuffer,
+  uint16_t dataLen,
+  bool dataReverse,
+  uint8_t *prfxBuffer,
+  uint16_t prfxLen,
+  bool prfxReverse,
+  bool prfxOnetime)
+{
+  // Prefix alone is not sent, since a device could take it as a command
+  if (dataLen == 0)
   {
-    prfxBuffer += prfxLen;
-    prfxBuffer--;
+    return setLastResult();
   }
+  Segment segments[] = {
+    { prfxBuffer, prfxLen, prfxReverse, !prfxOnetime, false },
+    { const_cast<uint8_t *>(dataBuffer), dataLen, dataReverse, false, true },
+  };
+  return busSendSegments(segments, sizeof(segments) / sizeof(segments[0]));
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busSendSegments(Segment *segments,
+                                                      uint8_t count)
+{
+  StatsScope stats(*this);
+  setLastResult();
   waitTimestampSend();
-  while (dataLen)
+  if (setLastResult(waitAck(getDevice())) ||
+      setLastResult(sendSegments(getDevice(), segments, count, getBusStop())))
   {
-    uint8_t pageLen = DataStreamProcessing::STREAM_BUFFER_LENGTH;
-    beginTransmission(getAddress());
-    // Injected prefix stream in every page
-    if (prfxExec)
+    return getLastResult();
+  }
+  stampDevice(getDevice(), isPageStop(getDevice(), true, getBusStop()));
+  return getLastResult();
+}
+
+gbj_twowire::ResultCodes gbj_twowire::sendSegments(Device &device,
+                                                   Segment *segments,
+                                                   uint8_t count,
+                                                   bool busStop)
+{
+  uint32_t headerLen = 0, streamLen = 0;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (segments[i].repeat)
+    {
+      headerLen += segments[i].dataLen;
+    }
+    else
+    {
+      streamLen += segments[i].dataLen;
+    }
+  }
+  // Nothing is sent for empty segments as for an empty stream
+  if (headerLen + streamLen == 0)
+  {
+    return ResultCodes::SUCCESS;
+  }
+  // Repeated segments do not fit into a page or leave no room for the stream
+  if (headerLen + device.positionBytes + (streamLen ? 1 : 0) >
+      device.pageLength)
+  {
+    return ResultCodes::ERROR_BUFFER;
+  }
+  uint8_t streamIdx = 0;
+  uint8_t *streamBuffer = nullptr;
+  uint16_t streamRest = 0;
+  uint8_t attempt = 0;
+  do
+  {
+    // Stream state at the start of the page for its repetition
+    uint8_t pageIdx = streamIdx;
+    uint8_t *pageBuffer = streamBuffer;
+    uint16_t pageRest = streamRest;
+    uint32_t pageStream = streamLen;
+    uint8_t pageLen = device.pageLength - device.positionBytes;
+    beginPage(device);
+    // Repeated segments at the start of every page
+    for (uint8_t i = 0; i < count && headerLen; i++)
+    {
+      if (segments[i].repeat)
+      {
+        uint8_t segmentLen = segments[i].dataLen;
+        uint8_t *segmentBuffer =
+          segments[i].dataReverse
+            ? segments[i].dataBuffer + segments[i].dataLen - 1
+            : segments[i].dataBuffer;
+        writeStream(segmentBuffer,
+                    segmentLen,
+                    segments[i].dataReverse,
+                    segments[i].progmem);
+        pageLen -= segmentLen;
+      }
+    }
+    // Other segments streamed across pages up to a device page boundary
+    uint8_t streamPage =
+      getPageLen(device, streamLen, device.pageLength - pageLen);
+    uint8_t pageBytes =
+      device.pageLength - device.positionBytes - pageLen + streamPage;
+    while (streamPage)
     {
-      uint16_t prfxLenPage = prfxLen;
-      uint8_t *prfxBufferPage = prfxBuffer;
-      while (pageLen > 0 && prfxLenPage > 0)
+      if (streamRest == 0)
       {
-        if (prfxReverse)
+        while (segments[streamIdx].repeat || segments[streamIdx].dataLen == 0)
         {
-          write(*prfxBufferPage--);
+          streamIdx++;
         }
-        else
-        {
-          write(*prfxBufferPage++);
-        };
-        pageLen--;
-        prfxLenPage--;
+        streamRest = segments[streamIdx].dataLen;
+        streamBuffer = segments[streamIdx].dataReverse
+                         ? segments[streamIdx].dataBuffer + streamRest - 1
+                         : segments[streamIdx].dataBuffer;
       }
-      if (prfxOnetime)
+      uint8_t segmentLen = min(streamRest, streamPage);
+      writeStream(streamBuffer,
+                  segmentLen,
+                  segments[streamIdx].dataReverse,
+                  segments[streamIdx].progmem);
+      streamRest -= segmentLen;
+      streamLen -= segmentLen;
+      streamPage -= segmentLen;
+      if (streamRest == 0)
       {
-        prfxExec = false;
+        streamIdx++;
       }
     }
-    // Main data stream
-    while (pageLen > 0 && dataLen > 0)
+    bool pageStop = isPageStop(device, streamLen == 0, busStop);
+    ResultCodes result = static_cast<ResultCodes>(endTransmission(pageStop));
+    if (isError(result))
     {
-      if (dataReverse)
+      if (!retryPage(device, result, attempt++))
       {
-        write(*dataBuffer--);
+        return result;
       }
-      else
+      streamIdx = pageIdx;
+      streamBuffer = pageBuffer;
+      streamRest = pageRest;
+      streamLen = pageStream;
+      continue;
+    }
+    attempt = 0;
+    device.pagePosition += pageStream - streamLen;
+    statPage(device, pageBytes, true, pageStop);
+    if (streamLen && isError(result = waitPage(device)))
+    {
+      return result;
+    }
+  } while (streamLen || attempt);
+  return ResultCodes::SUCCESS;
+}
+
+void gbj_twowire::writeStream(uint8_t *&dataBuffer,
+                              uint8_t dataLen,
+                              bool dataReverse,
+                              bool dataProgmem)
+{
+  if (dataProgmem)
+  {
+    uint8_t pageBuffer[DataStreamProcessing::STREAM_BUFFER_LENGTH];
+    if (dataReverse)
+    {
+      for (uint8_t i = 0; i < dataLen; i++)
       {
-        write(*dataBuffer++);
+        pageBuffer[i] = pgm_read_byte(dataBuffer--);
       }
-      pageLen--;
-      dataLen--;
     }
-    // Return original flag at last page
-    if (dataLen == 0)
+    else
     {
-      setBusStopFlag(origBusStop);
+      memcpy_P(pageBuffer, dataBuffer, dataLen);
+      dataBuffer += dataLen;
     }
-    if (setLastResult(static_cast<ResultCodes>(endTransmission(getBusStop()))))
+    write(pageBuffer, dataLen);
+  }
+  else if (dataReverse)
+  {
+    uint8_t pageBuffer[DataStreamProcessing::STREAM_BUFFER_LENGTH];
+    for (uint8_t i = 0; i < dataLen; i++)
     {
-      return getLastResult();
+      pageBuffer[i] = *dataBuffer--;
     }
+    write(pageBuffer, dataLen);
+  }
+  else
+  {
+    write(dataBuffer, dataLen);
+    dataBuffer += dataLen;
   }
-  setTimestamp();
-  setBusStopFlag(origBusStop);
-  return getLastResult();
 }
 
 gbj_twowire::ResultCodes gbj_twowire::busReceive(uint8_t *dataBuffer,
                                                  uint16_t dataLen,
                                                  bool dataReverse)
 {
-  bool origBusStop = getBusStop();
+  StatsScope stats(*this);
   setLastResult();
-  setBusRepeat();
-  if (dataReverse)
+  waitTimestampReceive();
+  if (setLastResult(waitAck(getDevice())) ||
+      setLastResult(receivePages(
+        getDevice(), dataBuffer, dataLen, dataReverse, getBusStop())))
   {
-    dataBuffer += dataLen;
-    dataBuffer--;
+    return getLastResult();
   }
-  waitTimestampReceive();
-  while (dataLen)
+  stampDevice(getDevice());
+  return getLastResult();
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busExecute(Transfer *transfers,
+                                                 uint8_t count)
+{
+  ResultCodes lastResult = ResultCodes::SUCCESS;
+  setLastResult();
+  for (uint8_t i = 0; i < count; i++)
   {
-    uint8_t pageLen = min(dataLen, DataStreamProcessing::STREAM_BUFFER_LENGTH);
-    // Return original flag before last page
-    if (pageLen >= dataLen)
+    // Repeated start between transfers, original flag after the last one
+    if (isError(executeTransfer(transfers[i],
+                                i + 1 < count ? false : getBusStop())) &&
+        isSuccess(lastResult))
     {
-      setBusStopFlag(origBusStop);
+      lastResult = transfers[i].result;
     }
-    if (requestFrom(getAddress(), pageLen, static_cast<uint8_t>(getBusStop())) >
-          0 &&
-        available() >= pageLen)
+  }
+  return setQueueResult(lastResult);
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busSchedule(Transfer *transfers,
+                                                  uint8_t count)
+{
+  ResultCodes lastResult = ResultCodes::SUCCESS;
+  uint8_t next = count;
+  setLastResult();
+  for (uint8_t i = 0; i < count; i++)
+  {
+    transfers[i].result = ResultCodes::ERROR_PENDING;
+  }
+  for (uint8_t done = 0; done < count; done++)
+  {
+    // Held bus continues with the same device, otherwise pick the ready
+    // transfer or the one with the shortest waiting, the first eligible one
+    // even with the saturated waiting
+    if (next == count)
     {
-      for (uint8_t i = 0; i < pageLen; i++)
+      uint32_t nextWait = 0xFFFFFFFF;
+      for (uint8_t i = 0; i < count && nextWait; i++)
       {
-        if (dataReverse)
-        {
-          *dataBuffer-- = read();
-        }
-        else
+        uint32_t wait = getTransferWait(transfers[i]);
+        if (transfers[i].result == ResultCodes::ERROR_PENDING &&
+            findTransfer(transfers, 0, i, transfers[i].address) == i &&
+            (next == count || wait < nextWait))
         {
-          *dataBuffer++ = read();
+          next = i;
+          nextWait = wait;
         }
       }
     }
-    else
+    Transfer &transfer = transfers[next];
+    // Keep the bus by repeated start for the next transfer of the same
+    // device if it needs no delay, otherwise release it for others
+    uint8_t follow = findTransfer(transfers, next + 1, count, transfer.address);
+    bool busStop = true;
+    if (follow < count)
     {
-      return setLastResult(ResultCodes::ERROR_RCV_DATA);
+      Device *device = findDevice(transfer.address);
+      bool dataSent = !(transfer.flags & TransferFlags::TRANSFER_RECEIVE);
+      busStop = false;
+      if (device && (transfers[follow].flags & TransferFlags::TRANSFER_RECEIVE))
+      {
+        busStop = device->receiveDelay || device->receiveDelayUs;
+      }
+      else if (device)
+      {
+        busStop = device->sendDelay || device->sendDelayUs;
+      }
+      // Device acknowledge polled after a send needs its STOP
+      busStop = busStop || (device && dataSent && device->ackTimeout);
     }
-    dataLen -= pageLen;
+    busStop = done + 1 < count ? busStop : getBusStop();
+    if (isError(executeTransfer(transfer, busStop)) && isSuccess(lastResult))
+    {
+      lastResult = transfer.result;
+    }
+    next = busStop || isError(transfer.result) ? count : follow;
   }
-  setTimestamp();
-  setBusStopFlag(origBusStop);
-  return getLastResult();
+  return setQueueResult(lastResult);
 }
 
-gbj_twowire::ResultCodes gbj_twowire::busReceive(uint16_t command,
-                                                 uint8_t *dataBuffer,
-                                                 uint16_t dataLen,
-                                                 bool dataReverse)
+gbj_twowire::ResultCodes gbj_twowire::executeTransfer(Transfer &transfer,
+                                                      bool busStop)
 {
-  bool origBusStop = getBusStop();
-  setBusRepeat();
-  if (busSend(setLastCommand(command)))
+#if defined(GBJ_TWOWIRE_STATS)
+  uint32_t timestamp = micros();
+#endif
+  bool dataReverse = transfer.flags & TransferFlags::TRANSFER_REVERSE;
+  bool dataReceive = transfer.flags & TransferFlags::TRANSFER_RECEIVE;
+  Device *device = findDevice(transfer.address);
+  // Unknown device is paged by defaults
+  Device defaults;
+  defaults.address = transfer.address;
+  Device &target = device ? *device : defaults;
+  if (device && dataReceive)
   {
-    return getLastResult();
+    waitTimestampReceive(*device);
   }
-  setBusStopFlag(origBusStop);
-  if (busReceive(dataBuffer, dataLen, dataReverse))
+  else if (device)
   {
-    return getLastResult();
+    waitTimestampSend(*device);
   }
-  return getLastResult();
+  // Device busy beyond polling timeout skips the transfer
+  transfer.result = device ? waitAck(*device) : ResultCodes::SUCCESS;
+  if (isSuccess(transfer.result) && dataReceive)
+  {
+    transfer.result = receivePages(target,
+                                   transfer.dataBuffer,
+                                   transfer.dataLen,
+                                   dataReverse,
+                                   busStop);
+  }
+  else if (isSuccess(transfer.result))
+  {
+    transfer.result = sendPages(target,
+                                transfer.dataBuffer,
+                                transfer.dataLen,
+                                dataReverse,
+                                busStop);
+  }
+  if (isError(transfer.result))
+  {
+    if (device)
+    {
+      device->errors++;
+    }
+#if defined(GBJ_TWOWIRE_ERRORS)
+    logError(target.address, target.lastCommand, transfer.result);
+#endif
+  }
+  else if (device)
+  {
+    stampDevice(*device, !dataReceive && isPageStop(target, true, busStop));
+  }
+#if defined(GBJ_TWOWIRE_STATS)
+  statTransaction(target, timestamp, transfer.result);
+#endif
+  return transfer.result;
 }
 
-String gbj_twowire::getLastErrorTxt(String location)
+uint8_t gbj_twowire::findTransfer(Transfer *transfers,
+                                  uint8_t start,
+                                  uint8_t count,
+                                  uint8_t address)
 {
-  String result = "";
-  result += location.length() ? location + "::" : "";
-  // Ignore success code
-  if (busStatus_.lastResult == ResultCodes::SUCCESS)
+  uint8_t i = start;
+  while (i < count && (transfers[i].address != address ||
+                       transfers[i].result != ResultCodes::ERROR_PENDING))
   {
-    result += "SUCCESS";
-    return result;
+    i++;
   }
-  result += "Error: ";
-  switch (busStatus_.lastResult)
-  {
-    // General
-    case ResultCodes::ERROR_ADDRESS:
-      result += "ERROR_ADDRESS";
-      break;
-
-    case ResultCodes::ERROR_PINS:
-      result += "ERROR_PINS";
-      break;
-
-    case ResultCodes::ERROR_RCV_DATA:
-      result += "ERROR_RCV_DATA";
-      break;
-
-    case ResultCodes::ERROR_POSITION:
-      result += "ERROR_POSITION";
-      break;
-
-    case ResultCodes::ERROR_DEVICE:
-      result += "ERROR_DEVICE";
-      break;
-
-    case ResultCodes::ERROR_RESET:
-      result += "ERROR_RESET";
-      break;
-
-    case ResultCodes::ERROR_FIRMWARE:
-      result += "ERROR_FIRMWARE";
-      break;
-
-    case ResultCodes::ERROR_SN:
-      result += "ERROR_SN";
-      break;
+  return i;
+}
 
-    case ResultCodes::ERROR_MEASURE:
-      result += "ERROR_MEASURE";
-      break;
+uint32_t gbj_twowire::getTransferWait(Transfer &transfer)
+{
+  Device *device = findDevice(transfer.address);
+  if (device == nullptr)
+  {
+    return 0;
+  }
+  bool dataReceive = transfer.flags & TransferFlags::TRANSFER_RECEIVE;
+  uint32_t delay = dataReceive ? device->receiveDelay : device->sendDelay;
+  uint32_t delayUs = dataReceive ? device->receiveDelayUs : device->sendDelayUs;
+  if (isDelayExpired(*device, delay, delayUs))
+  {
+    return 0;
+  }
+  // Waiting in microseconds saturates at about 71 minutes
+  uint32_t elapsed = millis() - device->transTimestamp;
+  uint32_t wait = 0;
+  if (elapsed < delay)
+  {
+    wait = delay - elapsed < 4294967 ? 1000 * (delay - elapsed) : 0xFFFFFFFF;
+  }
+  elapsed = micros() - device->transTimestampUs;
+  if (elapsed < delayUs && delayUs - elapsed > wait)
+  {
+    wait = delayUs - elapsed;
+  }
+  return wait;
+}
 
-    case ResultCodes::ERROR_REGISTER:
-      result += "ERROR_REGISTER";
-      break;
+gbj_twowire::ResultCodes gbj_twowire::selectDevice(uint8_t address)
+{
+  for (uint8_t i = 0; i < GBJ_TWOWIRE_DEVICES; i++)
+  {
+    if (devices_[i] && devices_[i]->address == address)
+    {
+      selectDevice(*devices_[i]);
+      return setLastResult();
+    }
+  }
+  return setLastResult(ResultCodes::ERROR_ADDRESS);
+}
 
-      // Arduino, Esspressif specific
-#if defined(__AVR__) || defined(ESP8266) || defined(ESP32)
-    case ResultCodes::ERROR_BUFFER:
-      result += "ERROR_BUFFER";
-      break;
+bool gbj_twowire::attachDevice(Device &device)
+{
+  for (uint8_t i = 0; i < GBJ_TWOWIRE_DEVICES; i++)
+  {
+    if (devices_[i] == &device)
+    {
+      return true;
+    }
+  }
+  for (uint8_t i = 0; i < GBJ_TWOWIRE_DEVICES; i++)
+  {
+    if (devices_[i] == nullptr)
+    {
+      devices_[i] = &device;
+      return true;
+    }
+  }
+  return false;
+}
 
-    case ResultCodes::ERROR_NACK_DATA:
-      result += "ERROR_NACK_DATA";
-      break;
+void gbj_twowire::detachDevice(Device &device)
+{
+  for (uint8_t i = 0; i < GBJ_TWOWIRE_DEVICES; i++)
+  {
+    if (devices_[i] == &device)
+    {
+      devices_[i] = nullptr;
+    }
+  }
+  if (device_ == &device)
+  {
+    selectDevice();
+  }
+}
 
-    case ResultCodes::ERROR_NACK_OTHER:
-      result += "ERROR_NACK_OTHER";
-      break;
+gbj_twowire::ResultCodes gbj_twowire::busScan(uint8_t *bitmap,
+                                              ScanModes mode,
+                                              uint32_t timeout)
+{
+  uint32_t timestamp = millis();
+  setLastResult();
+  if (scanAddress_ < getAddressMinUsual())
+  {
+    for (uint8_t i = 0; i < 16; i++)
+    {
+      bitmap[i] = 0;
+    }
+    scanAddress_ = getAddressMinUsual();
+  }
+  while (scanAddress_ <= getAddressMaxUsual())
+  {
+    if (probeAddress(scanAddress_, mode))
+    {
+      bitmap[scanAddress_ >> 3] |= 1 << (scanAddress_ & 0x07);
+    }
+    scanAddress_++;
+    // Budget checked after a probe, so that every call makes progress
+    if (timeout && millis() - timestamp >= timeout &&
+        scanAddress_ <= getAddressMaxUsual())
+    {
+      return ResultCodes::ERROR_PENDING;
+    }
+  }
+  scanAddress_ = 0;
+  return getLastResult();
+}
 
-      // Particle specific
-#elif defined(PARTICLE)
-    case ResultCodes::ERROR_BUSY:
-      result += "ERROR_BUSY";
-      break;
+bool gbj_twowire::probeAddress(uint8_t address, ScanModes mode)
+{
+  if (mode == ScanModes::SCAN_AUTO)
+  {
+    mode = (address >= 0x30 && address <= 0x37) ||
+               (address >= 0x50 && address <= 0x5F)
+             ? ScanModes::SCAN_READ
+             : ScanModes::SCAN_WRITE;
+  }
+  if (mode == ScanModes::SCAN_READ)
+  {
+    return requestFrom(address,
+                       static_cast<uint8_t>(1),
+                       static_cast<uint8_t>(true)) > 0;
+  }
+  beginTransmission(address);
+  return endTransmission(true) == 0;
+}
 
-    case ResultCodes::ERROR_END:
-      result += "ERROR_END";
-      break;
+uint8_t gbj_twowire::busIdentify(uint8_t address,
+                                 const Fingerprint *fingerprints,
+                                 uint8_t count)
+{
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (address < fingerprints[i].addressMin ||
+        address > fingerprints[i].addressMax)
+    {
+      continue;
+    }
+    // Identification register read by pointer and repeated START
+    uint8_t dataBuffer[2];
+    uint16_t dataLen = 0;
+    bufferData(dataBuffer, dataLen, fingerprints[i].command);
+    beginTransmission(address);
+    write(dataBuffer, dataLen);
+    if (endTransmission(false) == 0 &&
+        requestFrom(address,
+                    static_cast<uint8_t>(1),
+                    static_cast<uint8_t>(true)) > 0 &&
+        (read() & fingerprints[i].mask) == fingerprints[i].value)
+    {
+      return i;
+    }
+  }
+  return count;
+}
 
-    case ResultCodes::ERROR_TRANSFER:
-      result += "ERROR_TRANSFER";
-      break;
+gbj_twowire::Device *gbj_twowire::findDevice(uint8_t address)
+{
+  if (getDevice().address == address)
+  {
+    return &getDevice();
+  }
+  for (uint8_t i = 0; i < GBJ_TWOWIRE_DEVICES; i++)
+  {
+    if (devices_[i] && devices_[i]->address == address)
+    {
+      return devices_[i];
+    }
+  }
+  return nullptr;
+}
 
-    case ResultCodes::ERROR_TIMEOUT:
-      result += "ERROR_TIMEOUT";
-      break;
-#endif
-    default:
-      result += "ERROR_UKNOWN";
-      break;
+gbj_twowire::ResultCodes gbj_twowire::sendPages(Device &device,
+                                                uint8_t *dataBuffer,
+                                                uint16_t dataLen,
+                                                bool dataReverse,
+                                                bool busStop)
+{
+  if (dataReverse)
+  {
+    dataBuffer += dataLen;
+    dataBuffer--;
   }
-  result += " (" + String(busStatus_.lastResult) + ")";
-  // Last command
-  if (busStatus_.lastCommand)
+  while (dataLen)
   {
-    result += ", Command: 0x";
-    result += String(busStatus_.lastCommand, HEX);
+    uint8_t pageLen = getPageLen(device, dataLen, device.positionBytes);
+    uint8_t *pageBuffer;
+    ResultCodes result;
+    uint8_t attempt = 0;
+    dataLen -= pageLen;
+    bool pageStop = isPageStop(device, dataLen == 0, busStop);
+    statPage(device, pageLen, true, pageStop);
+    do
+    {
+      pageBuffer = dataBuffer;
+      beginPage(device);
+      writeStream(pageBuffer, pageLen, dataReverse);
+      result = static_cast<ResultCodes>(endTransmission(pageStop));
+    } while (isError(result) && retryPage(device, result, attempt++));
+    device.pagePosition += pageLen;
+    if (isError(result) || (dataLen && isError(result = waitPage(device))))
+    {
+      return result;
+    }
+    dataBuffer = pageBuffer;
   }
-  return result;
+  return ResultCodes::SUCCESS;
 }
+
+gbj_twowire::ResultCodes gbj_twowire::busSendCommand(uint8_t *dataBuffer,
+                                                     uint16_t dataLen)
+{
+  StatsScope stats(*this);
+  setLastResult();
+  waitTimestampSend();
+  if (setLastResult(waitAck(getDevice())))
+  {
+    return getLastResult();
+  }
+  ResultCodes result;
+  uint8_t attempt = 0;
+  statPage(getDevice(), dataLen, true, getBusStop());
+  do
+  {
+    beginTransmission(getAddress());
+    write(dataBuffer, dataLen);
+    result = static_cast<ResultCodes>(endTransmission(getBusStop()));
+  } while (isError(result) && retryPage(getDevice(), result, attempt++));
+  if (setLastResult(result))
+  {
+    return getLastResult();
+  }
+  stampDevice(getDevice(), getBusStop());
+  return getLastResult();
+}
+
+gbj_twowire::ResultCodes gbj_twowire::receivePages(Device &device,
+                                                   uint8_t *dataBuffer,
+                                                   uint16_t dataLen,
+                                                   bool dataReverse,
+                                                   bool busStop)
+{
+  if (dataReverse)
+  {
+    dataBuffer += dataLen;
+    dataBuffer--;
+  }
+  while (dataLen)
+  {
+    uint8_t pageLen = getPageLen(device, dataLen);
+    uint8_t attempt = 0;
+    dataLen -= pageLen;
+    device.pagePosition += pageLen;
+    statPage(device, pageLen, false, dataLen ? false : busStop);
+    // Repeated start between pages, requested condition after the last one
+    while (requestFrom(device.address,
+                       pageLen,
+                       static_cast<uint8_t>(dataLen ? false : busStop)) == 0 ||
+           available() < pageLen)
+    {
+      if (!retryPage(device, ResultCodes::ERROR_RCV_DATA, attempt++))
+      {
+        return ResultCodes::ERROR_RCV_DATA;
+      }
+    }
+    readStream(dataBuffer, pageLen, dataReverse);
+  }
+  return ResultCodes::SUCCESS;
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busReceive(StreamSink sink,
+                                                 uint32_t dataLen)
+{
+  StatsScope stats(*this);
+  uint8_t pageBuffer[DataStreamProcessing::STREAM_BUFFER_LENGTH];
+  uint32_t offset = 0;
+  setLastResult();
+  waitTimestampReceive();
+  if (setLastResult(waitAck(getDevice())))
+  {
+    return getLastResult();
+  }
+  while (offset < dataLen)
+  {
+    uint8_t pageLen = getPageLen(getDevice(), dataLen - offset);
+    uint8_t *pageStream = pageBuffer;
+    // Repeated start between pages, original flag at last page
+    bool pageStop = offset + pageLen < dataLen ? false : getBusStop();
+    uint8_t attempt = 0;
+    while (requestFrom(getAddress(),
+                       pageLen,
+                       static_cast<uint8_t>(pageStop)) == 0 ||
+           available() < pageLen)
+    {
+      if (!retryPage(getDevice(), ResultCodes::ERROR_RCV_DATA, attempt++))
+      {
+        return setLastResult(ResultCodes::ERROR_RCV_DATA);
+      }
+    }
+    readStream(pageStream, pageLen, false);
+    getDevice().pagePosition += pageLen;
+    statPage(getDevice(), pageLen, false, pageStop);
+    if (!sink(pageBuffer, pageLen, offset))
+    {
+      if (!pageStop)
+      {
+        releaseBus(getAddress());
+      }
+      return setLastResult(ResultCodes::ERROR_ABORTED);
+    }
+    offset += pageLen;
+  }
+  stampDevice(getDevice());
+  return getLastResult();
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busReceiveSegments(Segment *segments,
+                                                         uint8_t count)
+{
+  StatsScope stats(*this);
+  setLastResult();
+  waitTimestampReceive();
+  if (setLastResult(waitAck(getDevice())) ||
+      setLastResult(
+        receiveSegments(getDevice(), segments, count, getBusStop())))
+  {
+    return getLastResult();
+  }
+  stampDevice(getDevice());
+  return getLastResult();
+}
+
+gbj_twowire::ResultCodes gbj_twowire::receiveSegments(Device &device,
+                                                      Segment *segments,
+                                                      uint8_t count,
+                                                      bool busStop)
+{
+  uint32_t streamLen = 0;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    streamLen += segments[i].dataLen;
+  }
+  uint8_t streamIdx = 0;
+  uint8_t *streamBuffer = nullptr;
+  uint16_t streamRest = 0;
+  while (streamLen)
+  {
+    uint8_t pageLen = getPageLen(device, streamLen);
+    streamLen -= pageLen;
+    device.pagePosition += pageLen;
+    statPage(device, pageLen, false, streamLen ? false : busStop);
+    uint8_t attempt = 0;
+    // Repeated start between pages, requested condition after the last one
+    while (requestFrom(device.address,
+                       pageLen,
+                       static_cast<uint8_t>(streamLen ? false : busStop)) == 0 ||
+           available() < pageLen)
+    {
+      if (!retryPage(device, ResultCodes::ERROR_RCV_DATA, attempt++))
+      {
+        return ResultCodes::ERROR_RCV_DATA;
+      }
+    }
+    // Page distributed into segments
+    while (pageLen)
+    {
+      if (streamRest == 0)
+      {
+        while (segments[streamIdx].dataLen == 0)
+        {
+          streamIdx++;
+        }
+        streamRest = segments[streamIdx].dataLen;
+        streamBuffer = segments[streamIdx].dataReverse
+                         ? segments[streamIdx].dataBuffer + streamRest - 1
+                         : segments[streamIdx].dataBuffer;
+      }
+      uint8_t segmentLen = min(streamRest, pageLen);
+      readStream(streamBuffer, segmentLen, segments[streamIdx].dataReverse);
+      streamRest -= segmentLen;
+      pageLen -= segmentLen;
+      if (streamRest == 0)
+      {
+        streamIdx++;
+      }
+    }
+  }
+  return ResultCodes::SUCCESS;
+}
+
+void gbj_twowire::readStream(uint8_t *&dataBuffer,
+                             uint8_t dataLen,
+                             bool dataReverse)
+{
+  // Page occupies the same buffer area regardless of direction
+  uint8_t *pageBuffer = dataReverse ? dataBuffer - dataLen + 1 : dataBuffer;
+  if (isBlockRead(static_cast<Transport *>(this)))
+  {
+    readBytes(pageBuffer, dataLen);
+    if (dataReverse)
+    {
+      for (uint8_t i = 0, j = dataLen - 1; i < j; i++, j--)
+      {
+        uint8_t data = pageBuffer[i];
+        pageBuffer[i] = pageBuffer[j];
+        pageBuffer[j] = data;
+      }
+    }
+  }
+  else if (dataReverse)
+  {
+    for (uint8_t i = dataLen; i > 0; i--)
+    {
+      pageBuffer[i - 1] = read();
+    }
+  }
+  else
+  {
+    for (uint8_t i = 0; i < dataLen; i++)
+    {
+      pageBuffer[i] = read();
+    }
+  }
+  if (dataReverse)
+  {
+    dataBuffer -= dataLen;
+  }
+  else
+  {
+    dataBuffer += dataLen;
+  }
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busReceive(uint16_t command,
+                                                 uint8_t *dataBuffer,
+                                                 uint16_t dataLen,
+                                                 bool dataReverse)
+{
+  Register *cached = findRegister(getDevice(), command);
+  if (loadRegister(cached, dataBuffer, dataLen, dataReverse))
+  {
+    setLastCommand(command);
+    return setLastResult();
+  }
+  bool origBusStop = getBusStop();
+  setBusRepeat();
+  if (busSend(setLastCommand(command)))
+  {
+    return getLastResult();
+  }
+  setBusStopFlag(origBusStop);
+  if (busReceive(dataBuffer, dataLen, dataReverse))
+  {
+    return getLastResult();
+  }
+  storeRegister(cached, dataBuffer, dataLen, dataReverse);
+  return getLastResult();
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busUpdate(uint16_t command,
+                                                uint16_t mask,
+                                                uint16_t value,
+                                                uint8_t dataLen)
+{
+  uint8_t dataBuffer[4];
+  uint16_t commandLen = 0;
+  setLastResult();
+  if (dataLen == 0 || dataLen > 2)
+  {
+    return setLastResult(ResultCodes::ERROR_REGISTER);
+  }
+  StatsScope stats(*this);
+  bufferData(dataBuffer, commandLen, setLastCommand(command));
+  uint8_t *registerBuffer = dataBuffer + commandLen;
+  Register *cached = findRegister(getDevice(), command);
+  bool registerRead = !loadRegister(cached, registerBuffer, dataLen, false);
+  waitTimestampSend();
+  if (setLastResult(waitAck(getDevice())))
+  {
+    return getLastResult();
+  }
+  // Register pointer and reading chained by repeated START
+  if (registerRead)
+  {
+    uint8_t *pageBuffer = registerBuffer;
+    beginTransmission(getAddress());
+    write(dataBuffer, commandLen);
+    statPage(getDevice(), commandLen, true, false);
+    if (setLastResult(static_cast<ResultCodes>(endTransmission(false))))
+    {
+      return getLastResult();
+    }
+    statPage(getDevice(), dataLen, false, false);
+    if (requestFrom(getAddress(), dataLen, static_cast<uint8_t>(false)) == 0 ||
+        available() < dataLen)
+    {
+      return setLastResult(ResultCodes::ERROR_RCV_DATA);
+    }
+    readStream(pageBuffer, dataLen, false);
+  }
+  uint16_t origValue = getRegister(registerBuffer, dataLen, false);
+  uint16_t newValue = (origValue & ~mask) | (value & mask);
+  if (newValue == origValue)
+  {
+    // Bus held by the reading released at requested STOP
+    if (registerRead && getBusStop())
+    {
+      releaseBus(getAddress());
+    }
+    storeRegister(cached, origValue);
+    if (registerRead)
+    {
+      stampDevice(getDevice());
+    }
+    return getLastResult();
+  }
+  // Write-back of the register by repeated START
+  putRegister(registerBuffer, dataLen, false, newValue);
+  beginTransmission(getAddress());
+  write(dataBuffer, commandLen + dataLen);
+  statPage(getDevice(), commandLen + dataLen, true, getBusStop());
+  setLastResult(static_cast<ResultCodes>(endTransmission(getBusStop())));
+  storeRegister(cached, newValue);
+  if (isSuccess())
+  {
+    stampDevice(getDevice(), getBusStop());
+  }
+  return getLastResult();
+}
+
+gbj_twowire::Register *gbj_twowire::findRegister(Device &device,
+                                                 uint16_t command)
+{
+  for (uint8_t i = 0; i < device.registersCount; i++)
+  {
+    if (device.registers[i].command == command)
+    {
+      return &device.registers[i];
+    }
+  }
+  return nullptr;
+}
+
+bool gbj_twowire::loadRegister(Register *cached,
+                               uint8_t *dataBuffer,
+                               uint16_t dataLen,
+                               bool dataReverse)
+{
+  uint8_t cacheFlags = RegisterFlags::REGISTER_VALID |
+                       RegisterFlags::REGISTER_CACHEABLE |
+                       RegisterFlags::REGISTER_VOLATILE;
+  if (cached == nullptr || dataLen == 0 || dataLen > 2 ||
+      (cached->flags & cacheFlags) !=
+        (RegisterFlags::REGISTER_VALID | RegisterFlags::REGISTER_CACHEABLE))
+  {
+    return false;
+  }
+  // Register word in the stream direction as it would be received
+  putRegister(dataBuffer, dataLen, dataReverse, cached->value);
+  return true;
+}
+
+void gbj_twowire::storeRegister(Register *cached,
+                                uint8_t *dataBuffer,
+                                uint16_t dataLen,
+                                bool dataReverse)
+{
+  if (dataLen == 1 || dataLen == 2)
+  {
+    storeRegister(cached, getRegister(dataBuffer, dataLen, dataReverse));
+  }
+  else
+  {
+    storeRegister(cached, 0, false);
+  }
+}
+
+bool gbj_twowire::retryPage(Device &device, ResultCodes result, uint8_t attempt)
+{
+  if (attempt >= device.retries || result == ResultCodes::ERROR_BUFFER)
+  {
+    return false;
+  }
+#if defined(GBJ_TWOWIRE_ERRORS)
+  // Transient faults logged even if the repetition succeeds
+  logError(device.address, device.lastCommand, result);
+#endif
+#if defined(GBJ_TWOWIRE_STATS)
+  device.stats.retries++;
+#endif
+  // Bus held by a device after the failure
+  if (digitalRead(getBusPinSDA()) == LOW)
+  {
+#if defined(GBJ_TWOWIRE_STATS)
+    device.stats.recoveries++;
+#endif
+    if (isError(busRecover()))
+    {
+      return false;
+    }
+  }
+  // Backoff doubled for every next attempt
+  uint8_t shift = attempt < 15 ? attempt : 15;
+  waitUs(static_cast<uint32_t>(device.retryBackoffUs) << shift);
+  return true;
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busRecover()
+{
+  // Half period of the clock of 100 kHz
+  const uint8_t halfPeriodUs = 5;
+  uint8_t pinSDA = getBusPinSDA();
+  uint8_t pinSCL = getBusPinSCL();
+  // Bus lines taken over from the two-wire peripheral as open drain pins
+  release();
+  pinMode(pinSDA, INPUT_PULLUP);
+  pinMode(pinSCL, INPUT_PULLUP);
+  // Clock pulses shifting out the rest of a byte the device transmits
+  for (uint8_t i = 0; i < 9 && digitalRead(pinSDA) == LOW; i++)
+  {
+    digitalWrite(pinSCL, LOW);
+    pinMode(pinSCL, OUTPUT);
+    waitUs(halfPeriodUs);
+    pinMode(pinSCL, INPUT_PULLUP);
+    waitUs(halfPeriodUs);
+  }
+  // STOP as rising data line while the clock line is high
+  digitalWrite(pinSDA, LOW);
+  pinMode(pinSDA, OUTPUT);
+  waitUs(halfPeriodUs);
+  pinMode(pinSDA, INPUT_PULLUP);
+  waitUs(halfPeriodUs);
+  bool busFree = digitalRead(pinSDA) == HIGH && digitalRead(pinSCL) == HIGH;
+  initBus();
+  return setLastResult(busFree ? ResultCodes::SUCCESS
+                               : ResultCodes::ERROR_BUS_HELD);
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busSendStreamAsync(
+  uint8_t *dataBuffer,
+  uint16_t dataLen,
+  bool dataReverse,
+  TransferHandler handler)
+{
+  return startAsync(AsyncStates::ASYNC_SEND_WAIT,
+                    dataBuffer,
+                    dataLen,
+                    dataReverse,
+                    handler);
+}
+
+gbj_twowire::ResultCodes gbj_twowire::busReceiveAsync(
+  uint8_t *dataBuffer,
+  uint16_t dataLen,
+  bool dataReverse,
+  TransferHandler handler)
+{
+  return startAsync(AsyncStates::ASYNC_RECEIVE_WAIT,
+                    dataBuffer,
+                    dataLen,
+                    dataReverse,
+                    handler);
+}
+
+gbj_twowire::ResultCodes gbj_twowire::startAsync(AsyncStates state,
+                                                 uint8_t *dataBuffer,
+                                                 uint16_t dataLen,
+                                                 bool dataReverse,
+                                                 TransferHandler handler)
+{
+  if (isBusy())
+  {
+    return ResultCodes::ERROR_PENDING;
+  }
+  setLastResult();
+  if (dataReverse)
+  {
+    dataBuffer += dataLen;
+    dataBuffer--;
+  }
+  asyncStatus_.dataBuffer = dataBuffer;
+  asyncStatus_.dataLen = dataLen;
+  asyncStatus_.dataReverse = dataReverse;
+  asyncStatus_.busStop = getBusStop();
+  asyncStatus_.handler = handler;
+  asyncStatus_.device = &getDevice();
+#if defined(GBJ_TWOWIRE_STATS)
+  asyncStatus_.timestamp = micros();
+#endif
+  asyncStatus_.state = state;
+  return getLastResult();
+}
+
+gbj_twowire::ResultCodes gbj_twowire::probeAck(Device &device)
+{
+  if (!device.ackPending)
+  {
+    return ResultCodes::SUCCESS;
+  }
+  beginTransmission(device.address);
+  ResultCodes result = static_cast<ResultCodes>(endTransmission(true));
+  if (isSuccess(result))
+  {
+    device.ackPending = false;
+    return result;
+  }
+  return millis() - device.transTimestamp < device.ackTimeout
+           ? ResultCodes::ERROR_PENDING
+           : result;
+}
+
+gbj_twowire::ResultCodes gbj_twowire::waitAck(Device &device)
+{
+  ResultCodes result;
+  do
+  {
+    result = probeAck(device);
+  } while (result == ResultCodes::ERROR_PENDING);
+  return result;
+}
+
+gbj_twowire::ResultCodes gbj_twowire::waitPage(Device &device)
+{
+  if (!device.positionBytes)
+  {
+    return ResultCodes::SUCCESS;
+  }
+  stampDevice(device, true);
+  waitTimestampSend(device);
+  return waitAck(device);
+}
+
+bool gbj_twowire::finishAsync(ResultCodes result)
+{
+  bool dataSent = asyncStatus_.state == AsyncStates::ASYNC_SEND;
+  asyncStatus_.state = AsyncStates::ASYNC_IDLE;
+  // Failure belongs to the device of the transfer, not the selected one
+  Device &device = *asyncStatus_.device;
+  if (isError(result))
+  {
+    device.errors++;
+#if defined(GBJ_TWOWIRE_ERRORS)
+    logError(device.address, device.lastCommand, result);
+#endif
+  }
+  else
+  {
+    stampDevice(device,
+                dataSent && isPageStop(device, true, asyncStatus_.busStop));
+  }
+  setQueueResult(result);
+#if defined(GBJ_TWOWIRE_STATS)
+  statTransaction(device, asyncStatus_.timestamp, result);
+#endif
+  if (asyncStatus_.handler)
+  {
+    asyncStatus_.handler(result);
+  }
+  return false;
+}
+
+bool gbj_twowire::poll()
+{
+  if (asyncStatus_.state == AsyncStates::ASYNC_IDLE)
+  {
+    return false;
+  }
+  uint8_t pageLen = 0;
+  bool pageStop = false;
+  if (asyncStatus_.state == AsyncStates::ASYNC_SEND ||
+      asyncStatus_.state == AsyncStates::ASYNC_RECEIVE)
+  {
+    Device &device = *asyncStatus_.device;
+    bool dataSent = asyncStatus_.state == AsyncStates::ASYNC_SEND;
+    pageLen = getPageLen(
+      device, asyncStatus_.dataLen, dataSent ? device.positionBytes : 0);
+    bool lastPage = pageLen >= asyncStatus_.dataLen;
+    // Repeated start between pages, original flag at last page
+    pageStop = dataSent ? isPageStop(device, lastPage, asyncStatus_.busStop)
+                        : lastPage && asyncStatus_.busStop;
+  }
+  switch (asyncStatus_.state)
+  {
+    case AsyncStates::ASYNC_SEND_WAIT:
+      if (isTimestampSend(*asyncStatus_.device))
+      {
+        ResultCodes result = probeAck(*asyncStatus_.device);
+        if (isSuccess(result))
+        {
+          asyncStatus_.state = AsyncStates::ASYNC_SEND;
+        }
+        else if (result != ResultCodes::ERROR_PENDING)
+        {
+          return finishAsync(result);
+        }
+      }
+      return true;
+
+    case AsyncStates::ASYNC_RECEIVE_WAIT:
+      if (isTimestampReceive(*asyncStatus_.device))
+      {
+        ResultCodes result = probeAck(*asyncStatus_.device);
+        if (isSuccess(result))
+        {
+          asyncStatus_.state = AsyncStates::ASYNC_RECEIVE;
+        }
+        else if (result != ResultCodes::ERROR_PENDING)
+        {
+          return finishAsync(result);
+        }
+      }
+      return true;
+
+    case AsyncStates::ASYNC_SEND:
+      if (pageLen)
+      {
+        beginPage(*asyncStatus_.device);
+        writeStream(asyncStatus_.dataBuffer, pageLen, asyncStatus_.dataReverse);
+        asyncStatus_.dataLen -= pageLen;
+        asyncStatus_.device->pagePosition += pageLen;
+        statPage(*asyncStatus_.device, pageLen, true, pageStop);
+        ResultCodes result =
+          static_cast<ResultCodes>(endTransmission(pageStop));
+        if (isError(result))
+        {
+          return finishAsync(result);
+        }
+        // Write cycle of a device with position bytes awaited between pages
+        if (asyncStatus_.dataLen && asyncStatus_.device->positionBytes)
+        {
+          stampDevice(*asyncStatus_.device, true);
+          asyncStatus_.state = AsyncStates::ASYNC_SEND_WAIT;
+        }
+      }
+      break;
+
+    case AsyncStates::ASYNC_RECEIVE:
+      if (pageLen)
+      {
+        if (requestFrom(asyncStatus_.device->address,
+                        pageLen,
+                        static_cast<uint8_t>(pageStop)) == 0 ||
+            available() < pageLen)
+        {
+          return finishAsync(ResultCodes::ERROR_RCV_DATA);
+        }
+        readStream(asyncStatus_.dataBuffer, pageLen, asyncStatus_.dataReverse);
+        asyncStatus_.dataLen -= pageLen;
+        asyncStatus_.device->pagePosition += pageLen;
+        statPage(*asyncStatus_.device, pageLen, false, pageStop);
+      }
+      break;
+
+    case AsyncStates::ASYNC_IDLE:
+    default:
+      return false;
+  }
+  if (asyncStatus_.dataLen == 0)
+  {
+    return finishAsync(ResultCodes::SUCCESS);
+  }
+  return true;
+}
+
+// Names of result codes in program memory
+static const struct
+{
+  uint8_t code;
+  char name[17];
+} RESULT_NAMES[] PROGMEM = {
+  // General
+  { gbj_twowire::ERROR_ADDRESS, "ERROR_ADDRESS" },
+  { gbj_twowire::ERROR_PINS, "ERROR_PINS" },
+  { gbj_twowire::ERROR_RCV_DATA, "ERROR_RCV_DATA" },
+  { gbj_twowire::ERROR_POSITION, "ERROR_POSITION" },
+  { gbj_twowire::ERROR_DEVICE, "ERROR_DEVICE" },
+  { gbj_twowire::ERROR_RESET, "ERROR_RESET" },
+  { gbj_twowire::ERROR_FIRMWARE, "ERROR_FIRMWARE" },
+  { gbj_twowire::ERROR_SN, "ERROR_SN" },
+  { gbj_twowire::ERROR_MEASURE, "ERROR_MEASURE" },
+  { gbj_twowire::ERROR_REGISTER, "ERROR_REGISTER" },
+  { gbj_twowire::ERROR_PENDING, "ERROR_PENDING" },
+  { gbj_twowire::ERROR_ABORTED, "ERROR_ABORTED" },
+  { gbj_twowire::ERROR_BUS_HELD, "ERROR_BUS_HELD" },
+// Arduino, Esspressif specific
+#if defined(__AVR__) || defined(ESP8266) || defined(ESP32) ||                \
+  defined(GBJ_TWOWIRE_SIM)
+  { gbj_twowire::ERROR_BUFFER, "ERROR_BUFFER" },
+  { gbj_twowire::ERROR_NACK_DATA, "ERROR_NACK_DATA" },
+  { gbj_twowire::ERROR_NACK_OTHER, "ERROR_NACK_OTHER" },
+// Particle specific
+#elif defined(PARTICLE)
+  { gbj_twowire::ERROR_BUSY, "ERROR_BUSY" },
+  { gbj_twowire::ERROR_END, "ERROR_END" },
+  { gbj_twowire::ERROR_TRANSFER, "ERROR_TRANSFER" },
+  { gbj_twowire::ERROR_TIMEOUT, "ERROR_TIMEOUT" },
+#endif
+};
+
+String gbj_twowire::getLastErrorTxt(String location)
+{
+  // Longest text without location
+  char text[48];
+  getLastErrorTxt(text, sizeof(text));
+  return location.length() ? location + "::" + text : String(text);
+}
+
+size_t gbj_twowire::formatError(char *buffer,
+                                size_t size,
+                                const char *location,
+                                ResultCodes result,
+                                uint16_t command)
+{
+  size_t len = 0;
+  if (size == 0)
+  {
+    return len;
+  }
+  buffer[len] = '\0';
+  if (location && *location)
+  {
+    len = appendText(buffer, size, len, location);
+    len = appendText(buffer, size, len, PSTR("::"), true);
+  }
+  // Ignore success code
+  if (result == ResultCodes::SUCCESS)
+  {
+    return appendText(buffer, size, len, PSTR("SUCCESS"), true);
+  }
+  len = appendText(buffer, size, len, PSTR("Error: "), true);
+  uint8_t i = 0;
+  while (i < sizeof(RESULT_NAMES) / sizeof(RESULT_NAMES[0]) &&
+         pgm_read_byte(&RESULT_NAMES[i].code) != result)
+  {
+    i++;
+  }
+  len = appendText(buffer,
+                   size,
+                   len,
+                   i < sizeof(RESULT_NAMES) / sizeof(RESULT_NAMES[0])
+                     ? RESULT_NAMES[i].name
+                     : PSTR("ERROR_UKNOWN"),
+                   true);
+  len = appendText(buffer, size, len, PSTR(" ("), true);
+  len = appendNumber(buffer, size, len, result, DEC);
+  len = appendText(buffer, size, len, PSTR(")"), true);
+  // Last command
+  if (command)
+  {
+    len = appendText(buffer, size, len, PSTR(", Command: 0x"), true);
+    len = appendNumber(buffer, size, len, command, HEX);
+  }
+  return len;
+}
+
+size_t gbj_twowire::appendText(char *buffer,
+                               size_t size,
+                               size_t len,
+                               const char *text,
+                               bool progmem)
+{
+  char character;
+  while (len + 1 < size &&
+         (character = progmem ? pgm_read_byte(text) : *text) != '\0')
+  {
+    buffer[len++] = character;
+    text++;
+  }
+  buffer[len] = '\0';
+  return len;
+}
+
+size_t gbj_twowire::appendNumber(char *buffer,
+                                 size_t size,
+                                 size_t len,
+                                 uint32_t value,
+                                 uint8_t base)
+{
+  // Digits of a 32-bit number in reverse order
+  char digits[10];
+  uint8_t count = 0;
+  do
+  {
+    uint8_t digit = value % base;
+    // Lower case letters as String(value, HEX) prints them
+    digits[count++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    value /= base;
+  } while (value);
+  while (count && len + 1 < size)
+  {
+    buffer[len++] = digits[--count];
+  }
+  buffer[len] = '\0';
+  return len;
+}
+
+#if defined(GBJ_TWOWIRE_ERRORS)
+size_t gbj_twowire::getErrorEventTxt(char *buffer,
+                                     size_t size,
+                                     const ErrorEvent &event)
+{
+  size_t len = 0;
+  if (size == 0)
+  {
+    return len;
+  }
+  len = appendText(buffer, size, len, PSTR("0x"), true);
+  len = appendNumber(buffer, size, len, event.address, HEX);
+  len = appendText(buffer, size, len, PSTR(" at "), true);
+  len = appendNumber(buffer, size, len, event.timestamp, DEC);
+  len = appendText(buffer, size, len, PSTR(" ms::"), true);
+  return len + formatError(
+                 buffer + len, size - len, nullptr, event.result, event.command);
+}
+#endif
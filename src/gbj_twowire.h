@@ -25,17 +25,75 @@
   #include <Wire.h>
 #elif defined(PARTICLE)
   #include <Particle.h>
+  // Flash is mapped into address space
+  #ifndef pgm_read_byte
+    #define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+  #endif
+  #ifndef memcpy_P
+    #define memcpy_P memcpy
+  #endif
+  #ifndef PSTR
+    #define PSTR(str) (str)
+  #endif
+#elif defined(GBJ_TWOWIRE_SIM) || defined(__linux__)
+  #include "gbj_twowire_sim.h"
+#endif
+
+#ifndef GBJ_TWOWIRE_DEVICES
+  /// Number of device contexts attachable to a bus object
+  #define GBJ_TWOWIRE_DEVICES 4
+#endif
+
+#if defined(GBJ_TWOWIRE_STATS)
+  #ifndef GBJ_TWOWIRE_STATS_BUCKETS
+    /// Number of buckets of the histogram of transaction times
+    #define GBJ_TWOWIRE_STATS_BUCKETS 8
+  #endif
+  #ifndef GBJ_TWOWIRE_STATS_BUCKET_US
+    /// Upper bound of the first histogram bucket in microseconds, which is
+    /// doubled for every next bucket, the last one is unbounded
+    #define GBJ_TWOWIRE_STATS_BUCKET_US 128
+  #endif
+#endif
+
+#if defined(GBJ_TWOWIRE_ERRORS)
+  #ifndef GBJ_TWOWIRE_ERRORS_LENGTH
+    /// Number of recent error events kept in the error log
+    #define GBJ_TWOWIRE_ERRORS_LENGTH 8
+  #endif
+#endif
+
+#ifndef GBJ_TWOWIRE_BUFFER_LENGTH
+  /// Maximal page length, i.e., the transmit and receive buffer length of the
+  /// platform, which may be raised up to 255 bytes on cores with a resizable
+  /// buffer
+  #define GBJ_TWOWIRE_BUFFER_LENGTH BUFFER_LENGTH
+#endif
+// Page lengths are single bytes
+static_assert(GBJ_TWOWIRE_BUFFER_LENGTH <= 255,
+              "GBJ_TWOWIRE_BUFFER_LENGTH must not exceed 255 bytes");
+
+#include "gbj_twowire_bitbang.h"
+#ifndef GBJ_TWOWIRE_TRANSPORT
+  /// Transport class the driver derives from, i.e., the platform TwoWire
+  /// library, its host stand-in, or gbj_twowire_bitbang
+  #define GBJ_TWOWIRE_TRANSPORT TwoWire
 #endif
 
 /**
  * @class gbj_twowire
  * @brief Two-wire (I2C) bus driver.
  * @details Extends Arduino TwoWire class with extended error handling,
- * multi-platform support, and data streaming capabilities.
+ * multi-platform support, and data streaming capabilities. The extended
+ * class is the transport selected by the macro GBJ_TWOWIRE_TRANSPORT, so that
+ * bus primitives are resolved at compile time without virtual calls.
  */
-class gbj_twowire : public TwoWire
+class gbj_twowire : public GBJ_TWOWIRE_TRANSPORT
 {
 public:
+  /// Transport class selected at compile time
+  typedef GBJ_TWOWIRE_TRANSPORT Transport;
+
   // Boolean tag determining reverse order of bytes in stream transmission
   // (default: true)
   const bool REVERSE = true;
@@ -43,7 +101,8 @@ public:
   enum ResultCodes : uint8_t
   {
     SUCCESS = 0,
-#if defined(__AVR__) || defined(ESP8266) || defined(ESP32)
+#if defined(__AVR__) || defined(ESP8266) || defined(ESP32) ||                \
+  defined(GBJ_TWOWIRE_SIM)
     /// Data too long to fit in transmit buffer
     ERROR_BUFFER = 1,
     /// Received NACK on transmit of address
@@ -86,12 +145,301 @@ public:
     ERROR_MEASURE = 248,
     /// Operation with a register failure
     ERROR_REGISTER = 247,
+    /// Asynchronous transfer still in progress
+    ERROR_PENDING = 246,
+    /// Transfer aborted by a stream source or sink
+    ERROR_ABORTED = 245,
+    /// Serial data line held low by a device despite bus recovery
+    ERROR_BUS_HELD = 244,
+    /// Lowest custom result code, to be kept at the last one above
+    ERROR_CUSTOM_MIN = ERROR_BUS_HELD,
+  };
+
+  enum TransferFlags : uint8_t
+  {
+    /// Transfer sends data to the device
+    TRANSFER_SEND = 0,
+    /// Transfer receives data from the device
+    TRANSFER_RECEIVE = 1,
+    /// Transfer processes data buffer in reverse order
+    TRANSFER_REVERSE = 2,
+  };
+
+  enum ScanModes : uint8_t
+  {
+    /// Probe by an empty write (quick write)
+    SCAN_WRITE = 0,
+    /// Probe by reading one byte
+    SCAN_READ = 1,
+    /// Probe by reading at usual EEPROM and write-protect addresses, which
+    /// a quick write might corrupt, by an empty write elsewhere
+    SCAN_AUTO = 2,
+  };
+
+  enum RegisterFlags : uint8_t
+  {
+    /// Register readings may be served from the cache
+    REGISTER_CACHEABLE = 1,
+    /// Register is changed by the device itself, so it is never cached
+    REGISTER_VOLATILE = 2,
+    /// Cached value is valid, maintained by the library
+    REGISTER_VALID = 4,
+  };
+
+  /**
+   * @brief Compile time policy of packing words into a data stream.
+   * @details Counterpart of the runtime stream direction and bytes modes for
+   * drivers that never switch them, so that packing is straight-line code.
+   * @tparam MsbFirst Put the most significant byte first.
+   * @tparam AllBytes Put all bytes, otherwise omit the first byte of a word
+   * if it is zero.
+   */
+  template<bool MsbFirst, bool AllBytes>
+  struct StreamPolicy
+  {
+  };
+  typedef StreamPolicy<true, false> StreamMsbVal;
+  typedef StreamPolicy<true, true> StreamMsbAll;
+  typedef StreamPolicy<false, false> StreamLsbVal;
+  typedef StreamPolicy<false, true> StreamLsbAll;
+  /// Policy following the runtime stream modes of the selected device
+  struct StreamRuntime
+  {
+  };
+
+  /**
+   * @brief Value of fixed width packed in full into a data stream.
+   * @tparam Width Number of bytes.
+   */
+  template<uint8_t Width>
+  struct Value
+  {
+    uint32_t value;
+  };
+  typedef Value<1> Value8;
+  typedef Value<2> Value16;
+  typedef Value<3> Value24;
+  typedef Value<4> Value32;
+
+  /**
+   * @brief Segment of a scattered data stream.
+   * @details Repeated segments are put at the start of every page in their
+   * order, the other ones are streamed in their order across pages.
+   */
+  struct Segment
+  {
+    /// Data buffer of the segment
+    uint8_t *dataBuffer;
+    /// Number of bytes of the segment
+    uint16_t dataLen;
+    /// Process the segment in reverse order
+    bool dataReverse;
+    /// Repeat the segment at the start of every page
+    bool repeat;
+    /// Segment resides in program memory (PROGMEM), for sending only
+    bool progmem;
+  };
+
+  /**
+   * @brief Entry of a register cache.
+   * @details The value is a register word as sent by busSend(command, data)
+   * or received by busReceive(command, ...) of one or two bytes.
+   */
+  struct Register
+  {
+    /// Command (register address) of the register
+    uint16_t command;
+    /// Cached value of the register
+    uint16_t value;
+    /// Combination of RegisterFlags
+    uint8_t flags;
+  };
+
+  /**
+   * @brief Fingerprint of a known chip.
+   * @details The chip is recognized by its address range and by the masked
+   * byte of an identification register.
+   */
+  struct Fingerprint
+  {
+    /// Minimal address of the chip
+    uint8_t addressMin;
+    /// Maximal address of the chip
+    uint8_t addressMax;
+    /// Command (register address) of the identification register
+    uint16_t command;
+    /// Bits of the register to be compared
+    uint8_t mask;
+    /// Expected value of the masked bits
+    uint8_t value;
+  };
+
+  /**
+   * @brief Entry of a transaction queue.
+   * @details The result code is filled in by the execution.
+   */
+  struct Transfer
+  {
+    /// Address of the device
+    uint8_t address;
+    /// Combination of TransferFlags
+    uint8_t flags;
+    /// Data buffer to send from or to receive to
+    uint8_t *dataBuffer;
+    /// Number of bytes to transfer
+    uint16_t dataLen;
+    /// Result code of the transfer
+    ResultCodes result;
+  };
+
+#if defined(GBJ_TWOWIRE_STATS)
+  enum ResultCounts : uint8_t
+  {
+    /// Bus result codes counted by their value, higher ones at zero
+    RESULT_BUS_CODES = 6,
+    /// Number of counters of result codes, bus ones followed by custom ones
+    RESULT_COUNTS = RESULT_BUS_CODES + 0x100 - ERROR_CUSTOM_MIN,
+  };
+
+  /**
+   * @brief Transfer statistics of a device.
+   * @details A transaction is a call of a transfer method or a queue entry,
+   * a page is a bus transaction started by START or repeated START.
+   */
+  struct Statistics
+  {
+    /// Number of transactions
+    uint32_t transactions = 0;
+    /// Number of pages
+    uint32_t pages = 0;
+    /// Number of pages followed by repeated START instead of STOP
+    uint32_t repeatedStarts = 0;
+    /// Number of sent data bytes
+    uint32_t bytesSent = 0;
+    /// Number of received data bytes
+    uint32_t bytesReceived = 0;
+    /// Time spent waiting for send and receive delays in microseconds
+    uint32_t waitUs = 0;
+    /// Number of repeated pages after a failure
+    uint32_t retries = 0;
+    /// Number of bus recoveries before repeated pages
+    uint32_t recoveries = 0;
+    /// Number of transactions by result code, see getResultCount()
+    uint32_t results[ResultCounts::RESULT_COUNTS] = {};
+    /// Number of transactions by their duration, see
+    /// GBJ_TWOWIRE_STATS_BUCKET_US
+    uint32_t histogram[GBJ_TWOWIRE_STATS_BUCKETS] = {};
+  };
+#endif
+
+#if defined(GBJ_TWOWIRE_ERRORS)
+  /**
+   * @brief Record of a failed operation in the error log.
+   */
+  struct ErrorEvent
+  {
+    /// Time of the failure in milliseconds
+    uint32_t timestamp;
+    /// Recent command sent to the device
+    uint16_t command;
+    /// Address of the device
+    uint8_t address;
+    /// Result code of the failure
+    ResultCodes result;
+  };
+#endif
+
+  /**
+   * @brief Context of a device on the bus.
+   * @details Keeps everything specific for a device, so that multiple devices
+   * can share one bus object. The object has its own context used until
+   * another one is selected.
+   */
+  struct Device
+  {
+    /// Address of the device on two-wire bus
+    uint8_t address = 255;
+    /// Command code recently sent to the device
+    uint16_t lastCommand = 0;
+    /// Mode of data stream processing
+    uint8_t streamDirection = DataStreamProcessing::STREAM_DIR_MSB;
+    /// Mode of data stream bytes processing
+    uint8_t streamBytes = DataStreamProcessing::STREAM_BYTES_VAL;
+    /// Waiting after each sent page
+    uint32_t sendDelay = 0;
+    /// Waiting after each received page
+    uint32_t receiveDelay = 0;
+    /// Waiting after each sent page in microseconds
+    uint32_t sendDelayUs = 0;
+    /// Waiting after each received page in microseconds
+    uint32_t receiveDelayUs = 0;
+    /// Recent bus transmission timestamp
+    uint32_t transTimestamp = 0;
+    /// Recent bus transmission timestamp in microseconds
+    uint32_t transTimestampUs = 0;
+    /// Number of failed operations
+    uint16_t errors = 0;
+    /// Timeout of acknowledge polling after a send, zero for no polling
+    uint32_t ackTimeout = 0;
+    /// Device has not acknowledged since recent send yet
+    bool ackPending = false;
+    /// Maximal number of bytes in one bus transaction
+    uint8_t pageLength = DataStreamProcessing::STREAM_BUFFER_LENGTH;
+    /// Device page size, which pages must not cross, zero for none
+    uint16_t pageBoundary = 0;
+    /// Position of the next streamed byte in the device memory
+    uint32_t pagePosition = 0;
+    /// Number of bytes of the position sent at the start of every sent page,
+    /// zero for none
+    uint8_t positionBytes = 0;
+    /// Register cache entries
+    Register *registers = nullptr;
+    /// Number of register cache entries
+    uint8_t registersCount = 0;
+    /// Number of repetitions of a failed page
+    uint8_t retries = 0;
+    /// Waiting before the first repetition in microseconds, doubled for
+    /// every next one
+    uint16_t retryBackoffUs = 0;
+#if defined(GBJ_TWOWIRE_STATS)
+    /// Transfer statistics
+    Statistics stats;
+#endif
   };
 
+  /**
+   * @brief Handler called at completion of an asynchronous transfer.
+   * @param result Result code of the transfer.
+   */
+  typedef void (*TransferHandler)(ResultCodes result);
+
+  /**
+   * @brief Producer of a data stream called for every page to be sent.
+   * @param pageBuffer Buffer to be filled in with the page.
+   * @param pageLen Number of bytes of the page.
+   * @param offset Position of the page in the stream.
+   * @return True if the page has been provided, false to abort the transfer.
+   */
+  typedef bool (*StreamSource)(uint8_t *pageBuffer,
+                               uint8_t pageLen,
+                               uint32_t offset);
+
+  /**
+   * @brief Consumer of a data stream called for every received page.
+   * @param pageBuffer Buffer with the page.
+   * @param pageLen Number of bytes of the page.
+   * @param offset Position of the page in the stream.
+   * @return True if the page has been consumed, false to abort the transfer.
+   */
+  typedef bool (*StreamSink)(const uint8_t *pageBuffer,
+                             uint8_t pageLen,
+                             uint32_t offset);
+
   enum ClockSpeeds : uint32_t
   {
     CLOCK_100KHZ = 100000L,
     CLOCK_400KHZ = 400000L,
+    CLOCK_1MHZ = 1000000L,
   };
 
   /**
@@ -140,10 +488,11 @@ public:
    */
   inline void release()
   {
-#if defined(__AVR__) || defined(PARTICLE)
+#if defined(__AVR__) || defined(PARTICLE) || defined(GBJ_TWOWIRE_SIM)
     end();
 #endif
-#if defined(__AVR__) || defined(ESP8266) || defined(ESP32)
+#if defined(__AVR__) || defined(ESP8266) || defined(ESP32) ||                \
+  defined(GBJ_TWOWIRE_SIM)
     busStatus_.busEnabled = false;
 #endif
   }
@@ -161,10 +510,35 @@ public:
                             uint16_t dataLen,
                             bool dataReverse = false);
 
+  /**
+   * @brief Send byte stream from program memory to the I2C bus.
+   * @details Counterpart of busSendStream() for constant data in flash
+   * (PROGMEM), which is read page by page without a RAM copy.
+   * @param dataBuffer Pointer to data in program memory.
+   * @param dataLen Number of bytes to send.
+   * @param dataReverse Send bytes in reverse order (default: false).
+   * @return Result code.
+   */
+  ResultCodes busSendStream_P(const uint8_t *dataBuffer,
+                              uint16_t dataLen,
+                              bool dataReverse = false);
+
+  /**
+   * @brief Send byte stream provided by a source page by page.
+   * @details The stream need not be in memory at once, e.g., it is read
+   * from flash or an external memory, since only one page is buffered.
+   * @param source Function providing pages of the stream.
+   * @param dataLen Number of bytes of the stream.
+   * @return Result code, ERROR_ABORTED if the source failed.
+   */
+  ResultCodes busSendStream(StreamSource source, uint32_t dataLen);
+
   /**
    * @brief Send prefixed byte stream to the I2C bus.
    * @details Sends data prefixed with prefix buffer, chunked by bus buffer
    * size. Prefix can be sent once or repeated with each data page.
+   * It is a two segment case of busSendSegments(). Nothing is sent without
+   * data bytes.
    * @param dataBuffer Pointer to data buffer.
    * @param dataLen Number of data bytes.
    * @param dataReverse Send data bytes in reverse order.
@@ -183,10 +557,41 @@ public:
                                     bool prfxReverse,
                                     bool prfxOnetime = false);
 
+  /**
+   * @brief Send prefixed byte stream from program memory to the I2C bus.
+   * @details Counterpart of busSendStreamPrefixed() for data in flash
+   * (PROGMEM), while the prefix is in RAM.
+   * @return Result code.
+   */
+  ResultCodes busSendStreamPrefixed_P(const uint8_t *dataBuffer,
+                                      uint16_t dataLen,
+                                      bool dataReverse,
+                                      uint8_t *prfxBuffer,
+                                      uint16_t prfxLen,
+                                      bool prfxReverse,
+                                      bool prfxOnetime = false);
+
+  /**
+   * @brief Send byte stream scattered in several buffers to the I2C bus.
+   * @details The segments are streamed across pages without copying them
+   * into a contiguous buffer. Repeated segments are injected at the start of
+   * every page like the repeated prefix of busSendStreamPrefixed(), the
+   * other ones are streamed one after another. If there is no segment to be
+   * streamed, one page of repeated segments is sent. Segments may reside in
+   * RAM or in program memory.
+   * @param segments Array of segments.
+   * @param count Number of segments.
+   * @return Result code, ERROR_BUFFER if repeated segments exceed a page or
+   * leave no room for the other ones in it.
+   */
+  ResultCodes busSendSegments(Segment *segments, uint8_t count);
+
   /**
    * @brief Send one or two bytes to the I2C bus.
    * @details Overloaded method for simple command or command+data transmission.
-   * MSB is automatically handled (sent only if non-zero).
+   * MSB is automatically handled (sent only if non-zero). A command with
+   * data to a cached register is not sent if the register already has that
+   * value.
    * @param command Byte or word to send as command.
    * @param data Optional data byte or word to send after command.
    * @return Result code.
@@ -196,15 +601,70 @@ public:
     uint8_t dataBuffer[2];
     uint16_t dataLen = 0;
     bufferData(dataBuffer, dataLen, setLastCommand(command));
-    return busSendStream(dataBuffer, dataLen);
+    return busSendCommand(dataBuffer, dataLen);
   }
   inline ResultCodes busSend(uint16_t command, uint16_t data)
   {
     uint8_t dataBuffer[4];
     uint16_t dataLen = 0;
+    Register *cached = findRegister(getDevice(), command);
+    if (isRegisterWritten(cached, data))
+    {
+      setLastCommand(command);
+      return setLastResult();
+    }
     bufferData(dataBuffer, dataLen, setLastCommand(command));
     bufferData(dataBuffer, dataLen, data);
-    return busSendStream(dataBuffer, dataLen);
+    busSendCommand(dataBuffer, dataLen);
+    storeRegister(cached, data);
+    return getLastResult();
+  }
+
+  /**
+   * @brief Send command and data packed by a stream policy to the I2C bus.
+   * @details The command and data are written straight into the two-wire
+   * transmit buffer as one transmission without an intermediate buffer, so
+   * that they have to fit into the bus buffer length, otherwise the result
+   * is ERROR_BUFFER. Integers are packed as 16-bit words by the policy,
+   * values of the type Value are packed in full width in the direction of
+   * the policy.
+   * @tparam Policy One of StreamMsbVal, StreamMsbAll, StreamLsbVal,
+   * StreamLsbAll, or StreamRuntime.
+   * @param command Word to send as command.
+   * @param data Any number of words or values to send after command.
+   * @return Result code.
+   */
+  template<typename Policy, typename... Data>
+  inline ResultCodes busSend(uint16_t command, Data... data)
+  {
+    StatsScope stats(*this);
+    setLastResult();
+    waitTimestampSend();
+    if (setLastResult(waitAck(getDevice())))
+    {
+      return getLastResult();
+    }
+    ResultCodes result;
+    uint8_t attempt = 0;
+    do
+    {
+      beginTransmission(getAddress());
+      uint16_t dataLen = writeData(setLastCommand(command), Policy());
+      // Pack expansion evaluated in order of arguments
+      int order[] = { 0, (dataLen += writeData(data, Policy()), 0)... };
+      (void)order;
+      if (attempt == 0)
+      {
+        statPage(getDevice(), dataLen, true, getBusStop());
+      }
+      result = static_cast<ResultCodes>(endTransmission(getBusStop()));
+    } while (isError(result) && retryPage(getDevice(), result, attempt++));
+    if (setLastResult(result))
+    {
+      return getLastResult();
+    }
+    stampDevice(getDevice(), getBusStop());
+    return getLastResult();
   }
 
   /**
@@ -227,409 +687,1830 @@ public:
                          bool dataReverse = false);
 
   /**
-   * @brief Send general call software reset to all devices.
-   * @details Sends reset command (0x06) to general call address (0x00)
-   * to reset all devices on the bus that support it.
+   * @brief Update bits of a device register.
+   * @details Read-modify-write as one bus acquisition: the register pointer,
+   * the reading, and the write-back are chained by repeated START. Only the
+   * send delay is awaited before the sequence. A cacheable register with
+   * known value is not read, an unchanged value is not written back.
+   * @param command Command (register address) of the register.
+   * @param mask Bits of the register to be updated.
+   * @param value New value of the masked bits.
+   * @param dataLen Number of bytes of the register, 1 or 2 (default: 1).
+   * @return Result code, ERROR_REGISTER at wrong register length.
+   */
+  ResultCodes busUpdate(uint16_t command,
+                        uint16_t mask,
+                        uint16_t value,
+                        uint8_t dataLen = 1);
+
+  /**
+   * @brief Read byte stream from the I2C bus handing it over to a sink page
+   * by page.
+   * @details The stream need not fit into memory at once, e.g., it is
+   * written to a serial port, since only one page is buffered.
+   * @param sink Function consuming pages of the stream.
+   * @param dataLen Number of bytes of the stream.
+   * @return Result code, ERROR_ABORTED if the sink failed.
+   */
+  ResultCodes busReceive(StreamSink sink, uint32_t dataLen);
+
+  /**
+   * @brief Read byte stream from the I2C bus into several buffers.
+   * @details Received pages are distributed directly into the segments in
+   * their order, each one in its own byte order, e.g., a header, a sample
+   * block, and a checksum of one reading. The repeat and program memory
+   * flags of segments are ignored.
+   * @param segments Array of segments.
+   * @param count Number of segments.
    * @return Result code.
    */
-  inline ResultCodes busGeneralReset()
-  {
-    initBus();
-    beginTransmission(AddressRange::ADDRESS_GENCALL);
-    write(GeneralCall::GENCALL_RESET);
-    if (setLastResult(static_cast<ResultCodes>(endTransmission(getBusStop()))))
-    {
-      return getLastResult();
-    }
-    setTimestamp();
-    return getLastResult();
-  }
+  ResultCodes busReceiveSegments(Segment *segments, uint8_t count);
 
-  /// @name Setters
-  /// @{
   /**
-   * @brief Register device address without testing.
-   * @details Validates address is within valid range.
-   * @param address I2C address (0x00 - 0x7F).
+   * @brief Send byte stream of fixed length and order to the I2C bus.
+   * @details Compile time counterpart of the runtime busSendStream() for
+   * small frames of a driver. The page split and byte order are resolved at
+   * compile time, so that the transfer is straight-line code without loop
+   * counters, page length computation, and direction tests. A device with
+   * a shorter page length or a page boundary is paged at runtime.
+   * @tparam N Number of bytes to send.
+   * @tparam Reverse Send bytes in reverse order (default: false).
+   * @param dataBuffer Pointer to data buffer of N bytes to send.
    * @return Result code.
    */
-  inline ResultCodes registerAddress(uint8_t address)
+  template<uint16_t N, bool Reverse = false>
+  inline ResultCodes busSendStream(uint8_t *dataBuffer)
   {
+    StatsScope stats(*this);
     setLastResult();
-    // Invalid address
-    if (address < AddressRange::ADDRESS_MIN ||
-        address > AddressRange::ADDRESS_MAX)
-    {
-      return setLastResult(ResultCodes::ERROR_ADDRESS);
-    }
-    // No address change
-    if (address == getAddress())
+    waitTimestampSend();
+    if (setLastResult(waitAck(getDevice())) ||
+        setLastResult(
+          isPageFixed(N)
+            ? sendFixed<N, Reverse>(
+                dataBuffer,
+                getBusStop(),
+                FixedTag<(N <= DataStreamProcessing::STREAM_BUFFER_LENGTH)>())
+            : sendPages(getDevice(), dataBuffer, N, Reverse, getBusStop())))
     {
       return getLastResult();
     }
-    // Set changed address
-    busStatus_.address = address;
+    stampDevice(getDevice(), isPageStop(getDevice(), true, getBusStop()));
     return getLastResult();
   }
 
   /**
-   * @brief Set and test device address.
-   * @details Sets address and verifies communication by attempting
-   * transmission.
-   * @param address I2C address (0x00 - 0x7F).
+   * @brief Read byte stream of fixed length and order from the I2C bus.
+   * @details Compile time counterpart of the runtime busReceive().
+   * @tparam N Number of bytes to receive.
+   * @tparam Reverse Receive bytes in reverse order (default: false).
+   * @param dataBuffer Pointer to buffer for storing N received bytes.
    * @return Result code.
    */
-  inline ResultCodes setAddress(uint8_t address)
+  template<uint16_t N, bool Reverse = false>
+  inline ResultCodes busReceive(uint8_t *dataBuffer)
   {
-    if (isError(registerAddress(address)))
+    StatsScope stats(*this);
+    setLastResult();
+    waitTimestampReceive();
+    if (setLastResult(waitAck(getDevice())) ||
+        setLastResult(
+          isPageFixed(N)
+            ? receiveFixed<N, Reverse>(
+                dataBuffer,
+                getBusStop(),
+                FixedTag<(N <= DataStreamProcessing::STREAM_BUFFER_LENGTH)>())
+            : receivePages(getDevice(), dataBuffer, N, Reverse, getBusStop())))
     {
       return getLastResult();
     }
-    beginTransmission(getAddress());
-    return setLastResult(
-      static_cast<ResultCodes>(endTransmission(getBusStop())));
+    stampDevice(getDevice());
+    return getLastResult();
   }
 
   /**
-   * @brief Set I2C bus pins.
-   * @details Configures SDA and SCL pins. Validates pins are different.
-   * @param pinSDA Serial data pin number.
-   * @param pinSCL Serial clock pin number.
-   * @return Result code.
+   * @brief Execute queue of transfers as one bus acquisition.
+   * @details Transfers, possibly to different addresses, are executed back
+   * to back with repeated START between them and the STOP flag applied after
+   * the last one only. Transfers to the selected or an attached device await
+   * its send or receive delay and update its timestamp. A failed transfer
+   * does not abort the following ones, each one stores its own result code.
+   * @param transfers Array of queue entries.
+   * @param count Number of queue entries.
+   * @return Result code of the first failed transfer or SUCCESS.
    */
-  inline ResultCodes setPins(uint8_t pinSDA, uint8_t pinSCL)
-  {
-    busStatus_.pinSDA = pinSDA;
-    busStatus_.pinSCL = pinSCL;
-    setLastResult();
-    // Check pin duplicity
-    if (busStatus_.pinSDA == busStatus_.pinSCL)
-    {
-      return setLastResult(ResultCodes::ERROR_PINS);
-    }
-    return getLastResult();
-  }
+  ResultCodes busExecute(Transfer *transfers, uint8_t count);
 
   /**
-   * @brief Set result code of recent operation.
-   * @details Updates internal result status. Stops bus on error.
-   * @param lastResult Result code to set (default: SUCCESS).
-   * @return The result code that was set.
+   * @brief Execute transfers in the order the device delays allow.
+   * @details Instead of spinning on the delay of one device, the transfer
+   * that is ready (or becomes ready first) is executed, so that work on other
+   * devices fills the waiting. Transfers to the same address keep their
+   * queue order. Consecutive transfers to a device without delay between
+   * them are chained by repeated START, otherwise the bus is released with
+   * STOP after every transfer. Each entry stores its own result code.
+   * @param transfers Array of queue entries.
+   * @param count Number of queue entries.
+   * @return Result code of the first failed transfer or SUCCESS.
    */
-  inline ResultCodes setLastResult(
-    ResultCodes lastResult = ResultCodes::SUCCESS)
-  {
-    if (lastResult != ResultCodes::SUCCESS)
-    {
-      setBusStop();
-    }
-    busStatus_.lastResult = lastResult;
-    return busStatus_.lastResult;
-  }
+  ResultCodes busSchedule(Transfer *transfers, uint8_t count);
 
   /**
-   * @brief Set two-wire bus clock frequency.
-   * @details Updates bus clock speed. Takes effect at next I2C operation.
-   * @param clockSpeed Clock frequency (100 kHz or 400 kHz).
+   * @brief Start sending byte stream to the I2C bus asynchronously.
+   * @details Returns immediately. The transfer is advanced by poll(), which
+   * waits for the send delay without blocking and then sends one page per
+   * call. The data buffer must stay valid until completion.
+   * @param dataBuffer Pointer to data buffer to send.
+   * @param dataLen Number of bytes to send.
+   * @param dataReverse Send bytes in reverse order (default: false).
+   * @param handler Optional function called at completion (default: none).
+   * @return Result code (SUCCESS or ERROR_PENDING).
    */
-  inline void setBusClock(ClockSpeeds clockSpeed)
-  {
-    switch (clockSpeed)
-    {
-      case ClockSpeeds::CLOCK_100KHZ:
-      case ClockSpeeds::CLOCK_400KHZ:
-        busStatus_.clock = clockSpeed;
-        break;
-      default:
-        busStatus_.clock = ClockSpeeds::CLOCK_100KHZ;
-        break;
-    };
-#if defined(__AVR__) || defined(ESP8266) || defined(ESP32)
-    setClock(busStatus_.clock);
-#elif defined(PARTICLE)
-    setSpeed(busStatus_.clock);
-#endif
-  }
-  /// @}
+  ResultCodes busSendStreamAsync(uint8_t *dataBuffer,
+                                 uint16_t dataLen,
+                                 bool dataReverse = false,
+                                 TransferHandler handler = nullptr);
 
-  /// @name Getters
-  /// @{
   /**
-   * @brief Get result code of recent operation.
-   * @return Result code.
+   * @brief Start reading byte stream from the I2C bus asynchronously.
+   * @details Returns immediately. The transfer is advanced by poll(), which
+   * waits for the receive delay without blocking and then reads one page per
+   * call. The data buffer must stay valid until completion.
+   * @param dataBuffer Pointer to buffer for storing received data.
+   * @param dataLen Number of bytes to receive.
+   * @param dataReverse Receive bytes in reverse order (default: false).
+   * @param handler Optional function called at completion (default: none).
+   * @return Result code (SUCCESS or ERROR_PENDING).
    */
-  inline ResultCodes getLastResult()
-  {
-    if (busStatus_.lastResult != ResultCodes::SUCCESS)
-    {
-      setBusStop();
-    }
-    return busStatus_.lastResult;
-  }
+  ResultCodes busReceiveAsync(uint8_t *dataBuffer,
+                              uint16_t dataLen,
+                              bool dataReverse = false,
+                              TransferHandler handler = nullptr);
 
   /**
-   * @brief Get currently registered device address.
-   * @return I2C device address.
+   * @brief Advance asynchronous transfer.
+   * @details Should be called repeatedly from the loop. At completion it
+   * stores the result code, which is then available by getLastResult(), and
+   * calls the completion handler if any.
+   * @return True while the transfer is in progress, false when there is none.
    */
-  inline uint8_t getAddress() { return busStatus_.address; }
+  bool poll();
 
   /**
-   * @brief Get minimum valid I2C address.
-   * @return Minimum address (0x00).
+   * @brief Check if an asynchronous transfer is in progress.
+   * @return True if the transfer has not completed yet.
    */
-  inline uint8_t getAddressMin() { return AddressRange::ADDRESS_MIN; }
+  inline bool isBusy() { return asyncStatus_.state != AsyncStates::ASYNC_IDLE; }
 
+  /// @name Device contexts
+  /// @{
   /**
-   * @brief Get maximum valid I2C address.
-   * @return Maximum address (0x7F).
+   * @brief Select device context for subsequent operations.
+   * @details All device specific setters, getters, and transfers work with
+   * the selected context. The object's own context is selected without an
+   * argument.
+   * @param device Device context, which must stay valid while selected.
    */
-  inline uint8_t getAddressMax() { return AddressRange::ADDRESS_MAX; }
+  inline void selectDevice(Device &device) { device_ = &device; }
+  inline void selectDevice() { device_ = nullptr; }
 
   /**
-   * @brief Get minimum special purpose address.
-   * @return Minimum special address (0x01).
+   * @brief Select attached device context by its address.
+   * @param address I2C address of an attached device.
+   * @return Result code (SUCCESS or ERROR_ADDRESS if no such device).
    */
-  inline uint8_t getAddressMinSpecial()
-  {
+  ResultCodes selectDevice(uint8_t address);
+
+  /**
+   * @brief Attach device context to the bus object.
+   * @details Attached devices are found by address in transaction queues.
+   * @param device Device context, which must stay valid while attached.
+   * @return True if attached, false if all GBJ_TWOWIRE_DEVICES slots are used.
+   */
+  bool attachDevice(Device &device);
+
+  /**
+   * @brief Detach device context from the bus object.
+   * @details Selected context is deselected as well.
+   * @param device Device context.
+   */
+  void detachDevice(Device &device);
+
+  /**
+   * @brief Get selected device context.
+   * @return Reference to the context.
+   */
+  inline Device &getDevice() { return device_ ? *device_ : deviceStatus_; }
+
+  /**
+   * @brief Get number of failed operations of selected device.
+   * @return Error counter.
+   */
+  inline uint16_t getDeviceErrors() { return getDevice().errors; }
+
+  /**
+   * @brief Reset error counter of selected device.
+   */
+  inline void resetDeviceErrors() { getDevice().errors = 0; }
+  /// @}
+
+#if defined(GBJ_TWOWIRE_ERRORS)
+  /// @name Error log
+  /// @{
+  /**
+   * @brief Get number of error events in the error log.
+   * @return Number of events, at most GBJ_TWOWIRE_ERRORS_LENGTH.
+   */
+  inline uint8_t getErrorEvents() { return errorLog_.count; }
+
+  /**
+   * @brief Get an error event from the error log.
+   * @param index Order of the event from the most recent one (default: 0).
+   * @return Pointer to the event or nullptr if there is no such one.
+   */
+  inline const ErrorEvent *getErrorEvent(uint8_t index = 0)
+  {
+    if (index >= errorLog_.count)
+    {
+      return nullptr;
+    }
+    uint8_t position = (errorLog_.head + GBJ_TWOWIRE_ERRORS_LENGTH - 1 -
+                        index) % GBJ_TWOWIRE_ERRORS_LENGTH;
+    return &errorLog_.events[position];
+  }
+
+  /**
+   * @brief Convert an error event to human-readable text in a buffer.
+   * @details The text of getLastErrorTxt() located by the device address and
+   * the time of the event.
+   * @param buffer Pointer to a character buffer.
+   * @param size Size of the buffer including the terminating null.
+   * @param event Error event.
+   * @return Length of the text without the terminating null.
+   */
+  size_t getErrorEventTxt(char *buffer, size_t size, const ErrorEvent &event);
+
+  /**
+   * @brief Remove all events from the error log.
+   */
+  inline void clearErrorEvents() { errorLog_.head = errorLog_.count = 0; }
+  /// @}
+#endif
+
+#if defined(GBJ_TWOWIRE_STATS)
+  /// @name Statistics
+  /// @{
+  /**
+   * @brief Get transfer statistics of selected device.
+   * @return Reference to the statistics.
+   */
+  inline const Statistics &getStatistics() { return getDevice().stats; }
+
+  /**
+   * @brief Get number of transactions of selected device with a result code.
+   * @param result Result code.
+   * @return Number of transactions.
+   */
+  inline uint32_t getResultCount(ResultCodes result)
+  {
+    return getDevice().stats.results[getResultIndex(result)];
+  }
+
+  /**
+   * @brief Reset transfer statistics of selected device.
+   */
+  inline void resetStatistics() { getDevice().stats = Statistics(); }
+  /// @}
+#endif
+
+  /// @name Register cache
+  /// @{
+  /**
+   * @brief Set register cache of selected device.
+   * @details Writes of a value a non-volatile register already has are
+   * suppressed, readings of a cacheable register are served from the cache
+   * once its value is known. All values are invalidated.
+   * @param registers Array of entries with commands and flags, which must
+   * stay valid while used, nullptr for no cache.
+   * @param count Number of entries.
+   */
+  inline void setRegisterCache(Register *registers, uint8_t count)
+  {
+    getDevice().registers = registers;
+    getDevice().registersCount = registers ? count : 0;
+    invalidateRegisters();
+  }
+
+  /**
+   * @brief Invalidate cached value of a register of selected device.
+   * @param command Command (register address) of the register.
+   */
+  inline void invalidateRegister(uint16_t command)
+  {
+    storeRegister(findRegister(getDevice(), command), 0, false);
+  }
+
+  /**
+   * @brief Invalidate cached values of all registers of selected device,
+   * e.g., after its reset.
+   */
+  inline void invalidateRegisters() { invalidateRegisters(getDevice()); }
+  /// @}
+
+  /// @name Bus scanning
+  /// @{
+  /**
+   * @brief Scan the usual address range for present devices.
+   * @details Every address from getAddressMinUsual() to getAddressMaxUsual()
+   * is probed once with STOP. With a time budget the scan returns
+   * ERROR_PENDING after it is used up and continues with the next address at
+   * the next call, so that it can be spread across loop cycles.
+   * @param bitmap Buffer of 16 bytes for a bit per address, bit 0 of byte 0
+   * for address 0x00. It is cleared at the start of a scan.
+   * @param mode Probing mode (default: SCAN_WRITE).
+   * @param timeout Time budget of a call in milliseconds, zero for scanning
+   * at once (default: 0).
+   * @return Result code (SUCCESS or ERROR_PENDING).
+   */
+  ResultCodes busScan(uint8_t *bitmap,
+                      ScanModes mode = ScanModes::SCAN_WRITE,
+                      uint32_t timeout = 0);
+
+  /**
+   * @brief Check if a device has been found at an address by a scan.
+   * @param bitmap Bitmap of 16 bytes filled by busScan().
+   * @param address I2C address.
+   * @return True if the device is present.
+   */
+  inline bool isScanned(const uint8_t *bitmap, uint8_t address)
+  {
+    return bitmap[address >> 3] & (1 << (address & 0x07));
+  }
+
+  /**
+   * @brief Identify a chip at an address by fingerprints.
+   * @details Identification registers of fingerprints matching the address
+   * are read in their order until one of them has the expected value, so
+   * that chips sharing an address are told apart. The selected device is
+   * not changed.
+   * @param address I2C address of a present device.
+   * @param fingerprints Array of fingerprints of known chips.
+   * @param count Number of fingerprints.
+   * @return Index of the matching fingerprint or count if unknown.
+   */
+  uint8_t busIdentify(uint8_t address,
+                      const Fingerprint *fingerprints,
+                      uint8_t count);
+  /// @}
+
+  /**
+   * @brief Send general call software reset to all devices.
+   * @details Sends reset command (0x06) to general call address (0x00)
+   * to reset all devices on the bus that support it.
+   * @return Result code.
+   */
+  inline ResultCodes busGeneralReset()
+  {
+    initBus();
+    beginTransmission(AddressRange::ADDRESS_GENCALL);
+    write(GeneralCall::GENCALL_RESET);
+    // Reset devices forget their register values
+    invalidateRegisters(deviceStatus_);
+    for (uint8_t i = 0; i < GBJ_TWOWIRE_DEVICES; i++)
+    {
+      if (devices_[i])
+      {
+        invalidateRegisters(*devices_[i]);
+      }
+    }
+    if (setLastResult(static_cast<ResultCodes>(endTransmission(getBusStop()))))
+    {
+      return getLastResult();
+    }
+    setTimestamp();
+    return getLastResult();
+  }
+
+  /**
+   * @brief Recover the bus held by a device.
+   * @details A device interrupted in the middle of a byte it transmits may
+   * hold the serial data line low, so that the master cannot generate
+   * START anymore. The bus lines are driven as general purpose pins, the
+   * clock line is pulsed up to 9 times until the device releases the data
+   * line, then STOP is generated and the bus is initialized again.
+   * @return Result code, ERROR_BUS_HELD if the data line is still held low.
+   */
+  ResultCodes busRecover();
+
+  /// @name Setters
+  /// @{
+  /**
+   * @brief Register device address without testing.
+   * @details Validates address is within valid range.
+   * @param address I2C address (0x00 - 0x7F).
+   * @return Result code.
+   */
+  inline ResultCodes registerAddress(uint8_t address)
+  {
+    setLastResult();
+    // Invalid address
+    if (address < AddressRange::ADDRESS_MIN ||
+        address > AddressRange::ADDRESS_MAX)
+    {
+      return setLastResult(ResultCodes::ERROR_ADDRESS);
+    }
+    // No address change
+    if (address == getAddress())
+    {
+      return getLastResult();
+    }
+    // Set changed address
+    getDevice().address = address;
+    return getLastResult();
+  }
+
+  /**
+   * @brief Set and test device address.
+   * @details Sets address and verifies communication by attempting
+   * transmission.
+   * @param address I2C address (0x00 - 0x7F).
+   * @return Result code.
+   */
+  inline ResultCodes setAddress(uint8_t address)
+  {
+    if (isError(registerAddress(address)))
+    {
+      return getLastResult();
+    }
+    beginTransmission(getAddress());
+    return setLastResult(
+      static_cast<ResultCodes>(endTransmission(getBusStop())));
+  }
+
+  /**
+   * @brief Set I2C bus pins.
+   * @details Configures SDA and SCL pins. Validates pins are different.
+   * @param pinSDA Serial data pin number.
+   * @param pinSCL Serial clock pin number.
+   * @return Result code.
+   */
+  inline ResultCodes setPins(uint8_t pinSDA, uint8_t pinSCL)
+  {
+    busStatus_.pinSDA = pinSDA;
+    busStatus_.pinSCL = pinSCL;
+    setLastResult();
+    // Check pin duplicity
+    if (busStatus_.pinSDA == busStatus_.pinSCL)
+    {
+      return setLastResult(ResultCodes::ERROR_PINS);
+    }
+    return getLastResult();
+  }
+
+  /**
+   * @brief Set result code of recent operation.
+   * @details Updates internal result status. Stops bus on error.
+   * @param lastResult Result code to set (default: SUCCESS).
+   * @return The result code that was set.
+   */
+  inline ResultCodes setLastResult(
+    ResultCodes lastResult = ResultCodes::SUCCESS)
+  {
+    if (lastResult != ResultCodes::SUCCESS)
+    {
+      getDevice().errors++;
+#if defined(GBJ_TWOWIRE_ERRORS)
+      logError(getAddress(), getLastCommand(), lastResult);
+#endif
+    }
+    return setQueueResult(lastResult);
+  }
+
+  /**
+   * @brief Set two-wire bus clock frequency.
+   * @details Updates bus clock speed. Takes effect at next I2C operation.
+   * @param clockSpeed Clock frequency (100 kHz, 400 kHz, or 1 MHz).
+   */
+  inline void setBusClock(ClockSpeeds clockSpeed)
+  {
+    switch (clockSpeed)
+    {
+      case ClockSpeeds::CLOCK_100KHZ:
+      case ClockSpeeds::CLOCK_400KHZ:
+      case ClockSpeeds::CLOCK_1MHZ:
+        busStatus_.clock = clockSpeed;
+        break;
+      default:
+        busStatus_.clock = ClockSpeeds::CLOCK_100KHZ;
+        break;
+    };
+#if defined(__AVR__) || defined(ESP8266) || defined(ESP32) ||                \
+  defined(GBJ_TWOWIRE_SIM)
+    setClock(busStatus_.clock);
+#elif defined(PARTICLE)
+    setSpeed(busStatus_.clock);
+#endif
+  }
+  /// @}
+
+  /// @name Getters
+  /// @{
+  /**
+   * @brief Get result code of recent operation.
+   * @return Result code.
+   */
+  inline ResultCodes getLastResult()
+  {
+    if (busStatus_.lastResult != ResultCodes::SUCCESS)
+    {
+      setBusStop();
+    }
+    return busStatus_.lastResult;
+  }
+
+  /**
+   * @brief Get currently registered device address.
+   * @return I2C device address.
+   */
+  inline uint8_t getAddress() { return getDevice().address; }
+
+  /**
+   * @brief Get minimum valid I2C address.
+   * @return Minimum address (0x00).
+   */
+  inline uint8_t getAddressMin() { return AddressRange::ADDRESS_MIN; }
+
+  /**
+   * @brief Get maximum valid I2C address.
+   * @return Maximum address (0x7F).
+   */
+  inline uint8_t getAddressMax() { return AddressRange::ADDRESS_MAX; }
+
+  /**
+   * @brief Get minimum special purpose address.
+   * @return Minimum special address (0x01).
+   */
+  inline uint8_t getAddressMinSpecial()
+  {
     return AddressRange::ADDRESS_MIN_SPECIAL;
   }
 
   /**
-   * @brief Get minimum usual device address.
-   * @return Minimum usual address (0x03).
+   * @brief Get minimum usual device address.
+   * @return Minimum usual address (0x03).
+   */
+  inline uint8_t getAddressMinUsual()
+  {
+    return AddressRange::ADDRESS_MIN_USUAL;
+  }
+
+  /**
+   * @brief Get maximum usual device address.
+   * @return Maximum usual address (0x77).
+   */
+  inline uint8_t getAddressMaxUsual()
+  {
+    return AddressRange::ADDRESS_MAX_USUAL;
+  }
+
+  /**
+   * @brief Get SDA pin number.
+   * @return SDA pin.
+   */
+  inline uint8_t getPinSDA() { return busStatus_.pinSDA; }
+
+  /**
+   * @brief Get SCL pin number.
+   * @return SCL pin.
+   */
+  inline uint8_t getPinSCL() { return busStatus_.pinSCL; }
+
+  /**
+   * @brief Get recent command sent to the bus.
+   * @return Last command value.
+   */
+  inline uint16_t getLastCommand() { return getDevice().lastCommand; }
+
+  /**
+   * @brief Get bus clock frequency.
+   * @return Clock speed in Hz.
+   */
+  inline ClockSpeeds getBusClock() { return busStatus_.clock; }
+
+  /**
+   * @brief Check if recent operation was successful.
+   * @details Evaluates the internally stored result code.
+   * @return True if the stored result code is SUCCESS, false otherwise.
+   */
+  inline bool isSuccess()
+  {
+    return busStatus_.lastResult == ResultCodes::SUCCESS;
+  }
+
+  /**
+   * @brief Check if a given result code indicates success.
+   * @details Evaluates the provided result code directly without modifying
+   * internal state. Useful for evaluating return values of inline methods
+   * directly in conditional expressions.
+   * @param lastResult Result code to evaluate.
+   * @return True if lastResult is SUCCESS, false otherwise.
+   */
+  inline bool isSuccess(ResultCodes lastResult)
+  {
+    return lastResult == ResultCodes::SUCCESS;
+  }
+
+  /**
+   * @brief Check if recent operation resulted in an error.
+   * @details Evaluates the internally stored result code.
+   * @return True if the stored result code is not SUCCESS, false otherwise.
+   */
+  inline bool isError()
+  {
+    return !isSuccess();
+  }
+
+  /**
+   * @brief Check if a given result code indicates an error.
+   * @details Evaluates the provided result code directly without modifying
+   * internal state. Useful for evaluating return values of inline methods
+   * directly in conditional expressions.
+   * @param lastResult Result code to evaluate.
+   * @return True if lastResult is not SUCCESS, false otherwise.
+   */
+  inline bool isError(ResultCodes lastResult) { return !isSuccess(lastResult); }
+  /// @}
+
+  /**
+   * @brief Convert error code to human-readable text.
+   * @param location Optional location string for error context.
+   * @return Formatted error message.
+   */
+  String getLastErrorTxt(String location = "");
+
+  /**
+   * @brief Convert error code to human-readable text in a buffer.
+   * @details Counterpart of the String form without heap allocation. Names
+   * of result codes are read from program memory. The text is truncated to
+   * the buffer size and always terminated.
+   * @param buffer Pointer to a character buffer.
+   * @param size Size of the buffer including the terminating null.
+   * @param location Optional location for error context (default: none).
+   * @return Length of the text without the terminating null.
+   */
+  inline size_t getLastErrorTxt(char *buffer,
+                                size_t size,
+                                const char *location = nullptr)
+  {
+    return formatError(
+      buffer, size, location, busStatus_.lastResult, getLastCommand());
+  }
+
+  /**
+   * @brief Set send operation delay.
+   * @details Delays before subsequent send after completion of previous send.
+   * @param delay Wait time in milliseconds.
+   */
+  inline void setDelaySend(uint32_t delay) { getDevice().sendDelay = delay; }
+
+  /**
+   * @brief Get send operation delay.
+   * @return Delay in milliseconds.
+   */
+  inline uint32_t getDelaySend() { return getDevice().sendDelay; }
+
+  /**
+   * @brief Set receive operation delay.
+   * @details Delays before subsequent receive after completion of previous
+   * receive.
+   * @param delay Wait time in milliseconds.
+   */
+  inline void setDelayReceive(uint32_t delay)
+  {
+    getDevice().receiveDelay = delay;
+  }
+
+  /**
+   * @brief Get receive operation delay.
+   * @return Delay in milliseconds.
+   */
+  inline uint32_t getDelayReceive() { return getDevice().receiveDelay; }
+
+  /**
+   * @brief Set send operation delay in microseconds.
+   * @details Applies alongside the delay in milliseconds, the longer one
+   * takes effect. It suits delays shorter than or not aligned to a
+   * millisecond, which would be rounded up to a full millisecond otherwise.
+   * @param delay Wait time in microseconds.
+   */
+  inline void setDelaySendUs(uint32_t delay)
+  {
+    getDevice().sendDelayUs = delay;
+  }
+
+  /**
+   * @brief Get send operation delay in microseconds.
+   * @return Delay in microseconds.
+   */
+  inline uint32_t getDelaySendUs() { return getDevice().sendDelayUs; }
+
+  /**
+   * @brief Set receive operation delay in microseconds.
+   * @details Applies alongside the delay in milliseconds, the longer one
+   * takes effect.
+   * @param delay Wait time in microseconds.
+   */
+  inline void setDelayReceiveUs(uint32_t delay)
+  {
+    getDevice().receiveDelayUs = delay;
+  }
+
+  /**
+   * @brief Get receive operation delay in microseconds.
+   * @return Delay in microseconds.
+   */
+  inline uint32_t getDelayReceiveUs() { return getDevice().receiveDelayUs; }
+
+  /**
+   * @brief Set acknowledge polling mode.
+   * @details Before a transfer following a send, the device is addressed
+   * repeatedly by empty transmissions until it acknowledges, e.g., after an
+   * EEPROM write cycle or a sensor conversion. So that a transfer waits for
+   * the actual busy time instead of a worst case delay. Send and receive
+   * delays still apply before polling.
+   * @param timeout Time in milliseconds since the recent send, after which
+   * polling fails, zero for no polling.
+   */
+  inline void setAckPolling(uint32_t timeout)
+  {
+    getDevice().ackTimeout = timeout;
+    getDevice().ackPending = false;
+  }
+
+  /**
+   * @brief Get acknowledge polling timeout.
+   * @return Timeout in milliseconds, zero for no polling.
+   */
+  inline uint32_t getAckPolling() { return getDevice().ackTimeout; }
+
+  /**
+   * @brief Set automatic retry of failed pages.
+   * @details A page failed due to a transient fault, e.g., a NACK of a busy
+   * device or a glitch, is repeated after a backoff doubled for every next
+   * attempt, instead of aborting the transfer. A bus held by a device is
+   * recovered before a repetition. A fixed stream is paged at runtime then.
+   * @param retries Number of repetitions of a page, zero for no retry.
+   * @param backoffUs Waiting before the first repetition in microseconds
+   * (default: 0).
+   */
+  inline void setRetries(uint8_t retries, uint16_t backoffUs = 0)
+  {
+    getDevice().retries = retries;
+    getDevice().retryBackoffUs = backoffUs;
+  }
+
+  /**
+   * @brief Get number of repetitions of a failed page.
+   * @return Number of repetitions, zero for no retry.
+   */
+  inline uint8_t getRetries() { return getDevice().retries; }
+
+  /**
+   * @brief Set page length.
+   * @details Streams are split into bus transactions of at most this length,
+   * e.g., a display controller or a memory accepting shorter writes only.
+   * @param pageLength Number of bytes including position bytes, zero, not
+   * more than the position bytes, or more than the buffer length for the
+   * buffer length.
+   */
+  inline void setPageLength(uint8_t pageLength)
+  {
+    if (pageLength <= getDevice().positionBytes ||
+        pageLength > DataStreamProcessing::STREAM_BUFFER_LENGTH)
+    {
+      pageLength = DataStreamProcessing::STREAM_BUFFER_LENGTH;
+    }
+    getDevice().pageLength = pageLength;
+  }
+
+  /**
+   * @brief Get page length.
+   * @return Number of bytes.
+   */
+  inline uint8_t getPageLength() { return getDevice().pageLength; }
+
+  /**
+   * @brief Set device page boundary alignment.
+   * @details Stream pages are split additionally at multiples of the device
+   * page size, e.g., of an EEPROM, whose write wraps around within its page.
+   * The position follows streamed bytes, prefixes and repeated segments
+   * excluded, so that consecutive transfers keep the alignment.
+   * With position bytes, every sent page is a separate write of a memory
+   * starting with the page position as the word address, most significant
+   * byte first, and ending with STOP. The next page waits for the send delay
+   * and acknowledge polling, which should cover the write cycle.
+   * @param pageBoundary Device page size, zero for no alignment.
+   * @param pagePosition Position of the next streamed byte in the device
+   * memory (default: 0).
+   * @param positionBytes Number of bytes of the word address, at most 4 and
+   * less than the page length, zero for a device without it (default: 0).
+   */
+  inline void setPageBoundary(uint16_t pageBoundary,
+                              uint32_t pagePosition = 0,
+                              uint8_t positionBytes = 0)
+  {
+    if (positionBytes > sizeof(pagePosition))
+    {
+      positionBytes = sizeof(pagePosition);
+    }
+    if (positionBytes >= getDevice().pageLength)
+    {
+      positionBytes = getDevice().pageLength - 1;
+    }
+    getDevice().pageBoundary = pageBoundary;
+    getDevice().pagePosition = pagePosition;
+    getDevice().positionBytes = positionBytes;
+  }
+
+  /**
+   * @brief Set position of the next streamed byte in the device memory.
+   * @param pagePosition Memory position.
+   */
+  inline void setPagePosition(uint32_t pagePosition)
+  {
+    getDevice().pagePosition = pagePosition;
+  }
+
+  /**
+   * @brief Get device page size.
+   * @return Page size, zero for no alignment.
+   */
+  inline uint16_t getPageBoundary() { return getDevice().pageBoundary; }
+
+  /**
+   * @brief Get position of the next streamed byte in the device memory.
+   * @return Memory position.
+   */
+  inline uint32_t getPagePosition() { return getDevice().pagePosition; }
+
+  /**
+   * @brief Get number of bytes of the position sent at the start of pages.
+   * @return Number of bytes, zero for none.
+   */
+  inline uint8_t getPositionBytes() { return getDevice().positionBytes; }
+
+private:
+  enum AddressRange : uint8_t
+  {
+    /// Minimal valid address
+    ADDRESS_MIN = 0x00,
+    /// Maximal valid address
+    ADDRESS_MAX = 0x7F,
+    /// Minimal special purposes address
+    ADDRESS_MIN_SPECIAL = 0x01,
+    /// Minimal usual address
+    ADDRESS_MIN_USUAL = 0x03,
+    /// Maximal usual address
+    ADDRESS_MAX_USUAL = 0x77,
+    /// General call address
+    ADDRESS_GENCALL = 0x00,
+  };
+
+  enum GeneralCall : uint8_t
+  {
+    /// Software reset and write programmable part of slave address
+    GENCALL_RESET = 0x06,
+    /// Write programmable part of slave address only
+    GENCALL_WRITE = 0x04,
+  };
+
+  enum DataStreamProcessing : uint8_t
+  {
+    /// Process data stream with the least significant byte first
+    STREAM_DIR_LSB = 0,
+    /// Process data stream with the most significant byte first
+    STREAM_DIR_MSB = 1,
+    /// Process only non-zero bytes from LSB - ignore zero MSB bytes
+    STREAM_BYTES_VAL = 2,
+    /// Process all bytes of data stream regardless of their value
+    STREAM_BYTES_ALL = 3,
+    /// I2C Buffer length adopted from parent library
+    STREAM_BUFFER_LENGTH = GBJ_TWOWIRE_BUFFER_LENGTH,
+  };
+
+  struct BusStatus
+  {
+    /// Result of a recent operation
+    ResultCodes lastResult;
+    /// Clock frequency in Hz
+    ClockSpeeds clock;
+    /// Flag about releasing bus after end of transmission
+    bool busStop;
+    /// Pin for serial data
+    uint8_t pinSDA;
+    /// Pin for serial clock
+    uint8_t pinSCL;
+#if defined(__AVR__) || defined(ESP8266) || defined(ESP32) ||                \
+  defined(GBJ_TWOWIRE_SIM)
+    bool busEnabled = false; // Flag about bus initialization
+#endif
+  } busStatus_; /// Microcontroller status features
+
+  Device deviceStatus_; /// Own device context
+  Device *device_ = nullptr; /// Selected foreign device context
+  Device *devices_[GBJ_TWOWIRE_DEVICES] = {}; /// Attached device contexts
+  uint8_t scanAddress_ = 0; /// Next address of a scan in progress
+#if defined(GBJ_TWOWIRE_ERRORS)
+  struct ErrorLog
+  {
+    /// Ring buffer of events
+    ErrorEvent events[GBJ_TWOWIRE_ERRORS_LENGTH];
+    /// Position of the next event
+    uint8_t head = 0;
+    /// Number of stored events
+    uint8_t count = 0;
+  } errorLog_; /// Recent failed operations
+
+  /**
+   * @brief Record a failed operation in the error log.
+   * @details The oldest event is overwritten by a new one in a full log.
+   */
+  inline void logError(uint8_t address, uint16_t command, ResultCodes result)
+  {
+    ErrorEvent &event = errorLog_.events[errorLog_.head];
+    event.timestamp = millis();
+    event.command = command;
+    event.address = address;
+    event.result = result;
+    errorLog_.head = (errorLog_.head + 1) % GBJ_TWOWIRE_ERRORS_LENGTH;
+    if (errorLog_.count < GBJ_TWOWIRE_ERRORS_LENGTH)
+    {
+      errorLog_.count++;
+    }
+  }
+#endif
+
+  /**
+   * @brief Format a result code to human-readable text in a buffer.
+   * @param buffer Pointer to a character buffer.
+   * @param size Size of the buffer including the terminating null.
+   * @param location Location prefix or nullptr.
+   * @param result Result code.
+   * @param command Command of the operation, omitted if zero.
+   * @return Length of the text without the terminating null.
+   */
+  size_t formatError(char *buffer,
+                     size_t size,
+                     const char *location,
+                     ResultCodes result,
+                     uint16_t command);
+
+  /**
+   * @brief Append text to a terminated text in a buffer as far as it fits.
+   * @param buffer Pointer to a character buffer of nonzero size.
+   * @param size Size of the buffer including the terminating null.
+   * @param len Length of the text in the buffer.
+   * @param text Terminated text to append.
+   * @param progmem Flag about text in program memory (default: false).
+   * @return New length of the text in the buffer.
+   */
+  static size_t appendText(char *buffer,
+                           size_t size,
+                           size_t len,
+                           const char *text,
+                           bool progmem = false);
+
+  /**
+   * @brief Append a number to a terminated text in a buffer as far as it
+   * fits.
+   * @param value Number to append.
+   * @param base Numeral system, DEC or HEX.
+   * @return New length of the text in the buffer.
+   */
+  static size_t appendNumber(char *buffer,
+                             size_t size,
+                             size_t len,
+                             uint32_t value,
+                             uint8_t base);
+
+  /**
+   * @brief Probe an address for a device acknowledging it.
+   * @param address I2C address.
+   * @param mode Probing mode.
+   * @return True if the device acknowledged.
+   */
+  bool probeAddress(uint8_t address, ScanModes mode);
+
+  /**
+   * @brief Find device context by address.
+   * @details The selected context takes precedence over attached ones.
+   * @param address I2C address.
+   * @return Pointer to the context or nullptr if not found.
+   */
+  Device *findDevice(uint8_t address);
+
+  /**
+   * @brief Find register cache entry of a device by command.
+   * @param device Device context.
+   * @param command Command (register address).
+   * @return Pointer to the entry or nullptr if not cached.
+   */
+  Register *findRegister(Device &device, uint16_t command);
+
+  /**
+   * @brief Check if a cached register already has a value to be written.
+   * @param cached Cache entry or nullptr.
+   * @param value Value to be written.
+   * @return True if the write can be suppressed.
+   */
+  inline bool isRegisterWritten(Register *cached, uint16_t value)
+  {
+    return cached &&
+           (cached->flags & (RegisterFlags::REGISTER_VALID |
+                             RegisterFlags::REGISTER_VOLATILE)) ==
+             RegisterFlags::REGISTER_VALID &&
+           cached->value == value;
+  }
+
+  /**
+   * @brief Store a value into a register cache entry after a transfer.
+   * @param cached Cache entry or nullptr.
+   * @param value Value of the register.
+   * @param valid Flag about successful transfer, otherwise the value is
+   * unknown.
+   */
+  inline void storeRegister(Register *cached, uint16_t value, bool valid = true)
+  {
+    if (cached)
+    {
+      cached->value = value;
+      cached->flags &= ~RegisterFlags::REGISTER_VALID;
+      if (valid && isSuccess() &&
+          !(cached->flags & RegisterFlags::REGISTER_VOLATILE))
+      {
+        cached->flags |= RegisterFlags::REGISTER_VALID;
+      }
+    }
+  }
+
+  /**
+   * @brief Put register word into a buffer of one or two bytes in the stream
+   * direction.
+   */
+  inline void putRegister(uint8_t *dataBuffer,
+                          uint16_t dataLen,
+                          bool dataReverse,
+                          uint16_t value)
+  {
+    bool msbFirst =
+      (getStreamDir() == DataStreamProcessing::STREAM_DIR_MSB) != dataReverse;
+    if (dataLen == 1)
+    {
+      dataBuffer[0] = value;
+    }
+    else
+    {
+      dataBuffer[0] = msbFirst ? value >> 8 : value;
+      dataBuffer[1] = msbFirst ? value : value >> 8;
+    }
+  }
+
+  /**
+   * @brief Get register word from a buffer of one or two bytes in the
+   * stream direction.
+   */
+  inline uint16_t getRegister(uint8_t *dataBuffer,
+                              uint16_t dataLen,
+                              bool dataReverse)
+  {
+    bool msbFirst =
+      (getStreamDir() == DataStreamProcessing::STREAM_DIR_MSB) != dataReverse;
+    if (dataLen == 1)
+    {
+      return dataBuffer[0];
+    }
+    return msbFirst ? dataBuffer[0] << 8 | dataBuffer[1]
+                    : dataBuffer[1] << 8 | dataBuffer[0];
+  }
+
+  /**
+   * @brief Serve reading of a cacheable register from the cache.
+   * @return True if the reading has been served.
+   */
+  bool loadRegister(Register *cached,
+                    uint8_t *dataBuffer,
+                    uint16_t dataLen,
+                    bool dataReverse);
+
+  /**
+   * @brief Store reading of a register of one or two bytes into the cache.
+   */
+  void storeRegister(Register *cached,
+                     uint8_t *dataBuffer,
+                     uint16_t dataLen,
+                     bool dataReverse);
+
+  /**
+   * @brief Invalidate cached values of all registers of a device.
+   * @param device Device context.
+   */
+  inline void invalidateRegisters(Device &device)
+  {
+    for (uint8_t i = 0; i < device.registersCount; i++)
+    {
+      device.registers[i].flags &= ~RegisterFlags::REGISTER_VALID;
+    }
+  }
+
+  /**
+   * @brief Execute single queue entry and store its result code in it.
+   * @details Awaits the delay of the known target device, updates its
+   * timestamp on success or its error counter on failure. A failed transfer
+   * is logged here by its own address, but counted for no device if the
+   * address is unknown.
+   * @param transfer Queue entry.
+   * @param busStop Generate STOP after the transfer.
+   * @return Result code.
+   */
+  ResultCodes executeTransfer(Transfer &transfer, bool busStop);
+
+  /**
+   * @brief Set result code of a transaction queue or an asynchronous
+   * transfer.
+   * @details As setLastResult(), but without logging and counting the error
+   * for the selected device, since the failed transfers have been logged and
+   * counted for their own devices.
+   * @param lastResult Result code to set.
+   * @return The result code that was set.
+   */
+  inline ResultCodes setQueueResult(ResultCodes lastResult)
+  {
+    if (lastResult != ResultCodes::SUCCESS)
+    {
+      setBusStop();
+    }
+    busStatus_.lastResult = lastResult;
+    return busStatus_.lastResult;
+  }
+
+  /**
+   * @brief Find the first pending queue entry for an address.
+   * @param transfers Array of queue entries.
+   * @param start Index of the first entry to search.
+   * @param count Index behind the last entry to search.
+   * @param address I2C address.
+   * @return Index of the entry or count if none.
+   */
+  uint8_t findTransfer(Transfer *transfers,
+                       uint8_t start,
+                       uint8_t count,
+                       uint8_t address);
+
+  /**
+   * @brief Time in microseconds until the target device of a queue entry
+   * allows the transfer.
+   */
+  uint32_t getTransferWait(Transfer &transfer);
+
+  /**
+   * @brief Check if delay has expired since the recent transmission of a
+   * device.
+   * @details The microsecond timestamp wraps around in about 71 minutes,
+   * so it is consulted only if the millisecond one has not passed the
+   * microsecond delay yet by more than one millisecond, which the counter
+   * may tick right after the timestamp. Both differences are wraparound
+   * safe.
+   * @param device Device context.
+   * @param delay Delay in milliseconds.
+   * @param delayUs Delay in microseconds.
+   * @return True if the delay has expired.
+   */
+  inline bool isDelayExpired(Device &device, uint32_t delay, uint32_t delayUs)
+  {
+    uint32_t elapsed = millis() - device.transTimestamp;
+    return elapsed >= delay &&
+           (elapsed > delayUs / 1000 + 1 ||
+            micros() - device.transTimestampUs >= delayUs);
+  }
+
+  /**
+   * @brief Stamp recent transmission of a device by current time.
+   * @param device Device context.
+   * @param dataSent Flag about send transmission ended by STOP, after which
+   * the device should be polled for acknowledge if the mode is set. A send
+   * chained by repeated START, e.g., of a register pointer before reading,
+   * starts no write cycle.
+   */
+  inline void stampDevice(Device &device, bool dataSent = false)
+  {
+    device.transTimestampUs = micros();
+    device.transTimestamp = millis();
+    device.ackPending = dataSent && device.ackTimeout;
+  }
+
+#if defined(GBJ_TWOWIRE_STATS)
+  /**
+   * @brief Index of a result code in the statistics.
+   * @details Bus result codes keep their values, custom ones from
+   * ERROR_CUSTOM_MIN up follow them.
+   */
+  static inline uint8_t getResultIndex(ResultCodes result)
+  {
+    static_assert(static_cast<uint8_t>(ResultCodes::ERROR_CUSTOM_MIN) >
+                      ResultCounts::RESULT_BUS_CODES &&
+                    0xFF - ResultCodes::ERROR_CUSTOM_MIN +
+                        ResultCounts::RESULT_BUS_CODES <
+                      sizeof(Statistics::results) / sizeof(uint32_t),
+                  "Result code index out of statistics");
+    uint8_t code = result;
+    return code < ResultCodes::ERROR_CUSTOM_MIN
+             ? (code < ResultCounts::RESULT_BUS_CODES ? code : 0)
+             : code - ResultCodes::ERROR_CUSTOM_MIN +
+                 ResultCounts::RESULT_BUS_CODES;
+  }
+
+  /**
+   * @brief Count a page of a transaction into statistics of a device.
+   * @param device Device context.
+   * @param pageLen Number of data bytes of the page.
+   * @param dataSent Flag about sent page.
+   * @param busStop Flag about STOP after the page, otherwise repeated START.
+   */
+  inline void statPage(Device &device,
+                       uint16_t pageLen,
+                       bool dataSent,
+                       bool busStop)
+  {
+    device.stats.pages++;
+    device.stats.repeatedStarts += !busStop;
+    (dataSent ? device.stats.bytesSent : device.stats.bytesReceived) +=
+      pageLen;
+  }
+
+  /**
+   * @brief Count a transaction into statistics of a device.
+   * @param device Device context.
+   * @param timestamp Start of the transaction in microseconds.
+   * @param result Result code of the transaction.
+   */
+  inline void statTransaction(Device &device,
+                              uint32_t timestamp,
+                              ResultCodes result)
+  {
+    uint32_t elapsed = micros() - timestamp;
+    uint8_t bucket = 0;
+    for (uint32_t bound = GBJ_TWOWIRE_STATS_BUCKET_US;
+         elapsed >= bound && bucket < GBJ_TWOWIRE_STATS_BUCKETS - 1;
+         bound <<= 1)
+    {
+      bucket++;
+    }
+    device.stats.transactions++;
+    device.stats.results[getResultIndex(result)]++;
+    device.stats.histogram[bucket]++;
+  }
+
+  /**
+   * @brief Statistics of a transaction of the selected device counted at
+   * leaving the scope of a transfer method by its last result code.
+   */
+  class StatsScope
+  {
+  public:
+    inline explicit StatsScope(gbj_twowire &bus)
+      : bus_(bus)
+      , device_(bus.getDevice())
+      , timestamp_(micros())
+    {
+    }
+    inline ~StatsScope()
+    {
+      bus_.statTransaction(device_, timestamp_, bus_.getLastResult());
+    }
+
+  private:
+    gbj_twowire &bus_;
+    Device &device_;
+    uint32_t timestamp_;
+  };
+#else
+  inline void statPage(Device &, uint16_t, bool, bool) {}
+  class StatsScope
+  {
+  public:
+    inline explicit StatsScope(gbj_twowire &) {}
+  };
+#endif
+
+  /**
+   * @brief Address a device by an empty transmission once if it should be
+   * polled for acknowledge.
+   * @param device Device context.
+   * @return SUCCESS if the device acknowledged or need not be polled,
+   * ERROR_PENDING if it has not acknowledged yet, or the result code of
+   * the recent attempt after the timeout.
+   */
+  ResultCodes probeAck(Device &device);
+
+  /**
+   * @brief Poll a device for acknowledge until it acknowledges or the
+   * timeout expires.
+   * @param device Device context.
+   * @return Result code.
+   */
+  ResultCodes waitAck(Device &device);
+
+  enum AsyncStates : uint8_t
+  {
+    /// No asynchronous transfer
+    ASYNC_IDLE,
+    /// Waiting for send delay expiration
+    ASYNC_SEND_WAIT,
+    /// Sending pages
+    ASYNC_SEND,
+    /// Waiting for receive delay expiration
+    ASYNC_RECEIVE_WAIT,
+    /// Receiving pages
+    ASYNC_RECEIVE,
+  };
+
+  struct AsyncStatus
+  {
+    /// Phase of the transfer
+    AsyncStates state = AsyncStates::ASYNC_IDLE;
+    /// Next byte of the data buffer
+    uint8_t *dataBuffer;
+    /// Number of bytes still to transfer
+    uint16_t dataLen;
+    /// Flag about reverse order of bytes
+    bool dataReverse;
+    /// Bus stop flag at the start of the transfer used at its last page
+    bool busStop;
+    /// Completion handler
+    TransferHandler handler;
+    /// Device context of the transfer
+    Device *device = nullptr;
+#if defined(GBJ_TWOWIRE_STATS)
+    /// Start of the transfer in microseconds
+    uint32_t timestamp;
+#endif
+  } asyncStatus_; /// Asynchronous transfer status
+
+  /**
+   * @brief Start asynchronous transfer.
+   * @param state Initial waiting state determining direction.
+   * @return Result code (SUCCESS or ERROR_PENDING).
+   */
+  ResultCodes startAsync(AsyncStates state,
+                         uint8_t *dataBuffer,
+                         uint16_t dataLen,
+                         bool dataReverse,
+                         TransferHandler handler);
+
+  /**
+   * @brief Finish asynchronous transfer.
+   * @details A failure is logged and counted for the device context of the
+   * transfer regardless of the device selected meanwhile.
+   * @param result Result code of the transfer.
+   * @return False as a flag about no transfer in progress.
+   */
+  bool finishAsync(ResultCodes result);
+
+  /**
+   * @brief Set recent command sent to bus.
+   * @param lastCommand Command value.
+   * @return The command value.
+   */
+  inline uint16_t setLastCommand(uint16_t lastCommand)
+  {
+    return getDevice().lastCommand = lastCommand;
+  }
+
+  /**
+   * @brief Buffer data word according to stream settings.
+   * @details Updates buffer from index with data according to stream direction
+   * and byte processing modes, and advances index.
+   * @param dataBuffer Pointer to byte buffer to update.
+   * @param dataIdx Reference to buffer index (will be incremented).
+   * @param data Data word to buffer.
+   */
+  inline void bufferData(uint8_t *dataBuffer, uint16_t &dataIdx, uint16_t data)
+  {
+    uint8_t dataLSB = data & 0xFF;
+    uint8_t dataMSB = (data >> 8) & 0xFF;
+    switch (getStreamDir())
+    {
+      case DataStreamProcessing::STREAM_DIR_MSB:
+        if ((getStreamBytes() == DataStreamProcessing::STREAM_BYTES_ALL) ||
+            dataMSB)
+        {
+          dataBuffer[dataIdx++] = dataMSB;
+        }
+        dataBuffer[dataIdx++] = dataLSB;
+        break;
+      case DataStreamProcessing::STREAM_DIR_LSB:
+      default:
+        if ((getStreamBytes() == DataStreamProcessing::STREAM_BYTES_ALL) ||
+            dataLSB)
+        {
+          dataBuffer[dataIdx++] = dataLSB;
+        }
+        dataBuffer[dataIdx++] = dataMSB;
+        break;
+    }
+  }
+
+  /**
+   * @brief Length of the next page of a stream to a device.
+   * @details The page is limited by the page length of the device reduced
+   * by a header, by the rest of its current device page, and by the rest of
+   * the stream.
+   * @param device Device context.
+   * @param dataLen Number of stream bytes still to transfer.
+   * @param headerLen Number of bytes of position and repeated segments in
+   * the page, less than the page length.
+   * @return Number of stream bytes of the page.
+   */
+  inline uint8_t getPageLen(Device &device,
+                            uint32_t dataLen,
+                            uint8_t headerLen = 0)
+  {
+    uint8_t pageLen = device.pageLength - headerLen;
+    if (device.pageBoundary)
+    {
+      uint16_t boundaryLen =
+        device.pageBoundary - device.pagePosition % device.pageBoundary;
+      if (boundaryLen < pageLen)
+      {
+        pageLen = boundaryLen;
+      }
+    }
+    return dataLen < pageLen ? dataLen : pageLen;
+  }
+
+  /**
+   * @brief Start a transmission of a sent page to a device.
+   * @details The page position is written as the word address of a device
+   * with position bytes.
+   * @param device Device context.
    */
-  inline uint8_t getAddressMinUsual()
+  inline void beginPage(Device &device)
   {
-    return AddressRange::ADDRESS_MIN_USUAL;
+    beginTransmission(device.address);
+    for (uint8_t i = device.positionBytes; i; i--)
+    {
+      write(static_cast<uint8_t>(device.pagePosition >> 8 * (i - 1)));
+    }
   }
 
   /**
-   * @brief Get maximum usual device address.
-   * @return Maximum usual address (0x77).
+   * @brief Condition after a sent page.
+   * @details Pages of a device with position bytes are separate writes
+   * ended by STOP, otherwise pages are chained with repeated START and the
+   * last one ends with the requested condition.
+   * @param device Device context.
+   * @param lastPage Flag about the last page of a transfer.
+   * @param busStop Requested condition after the last page.
+   * @return True for STOP.
    */
-  inline uint8_t getAddressMaxUsual()
+  inline bool isPageStop(Device &device, bool lastPage, bool busStop)
   {
-    return AddressRange::ADDRESS_MAX_USUAL;
+    return device.positionBytes || (lastPage && busStop);
   }
 
   /**
-   * @brief Get SDA pin number.
-   * @return SDA pin.
+   * @brief Wait for the write cycle of a device with position bytes after a
+   * sent page, which is not the last one.
+   * @param device Device context.
+   * @return Result code.
    */
-  inline uint8_t getPinSDA() { return busStatus_.pinSDA; }
+  ResultCodes waitPage(Device &device);
 
   /**
-   * @brief Get SCL pin number.
-   * @return SCL pin.
+   * @brief Send byte stream to a device in pages.
+   * @details Pages are chained as decided by isPageStop(). Neither result
+   * code nor timestamp is stored.
+   * @param device Context of the device.
+   * @param dataBuffer Pointer to data buffer to send.
+   * @param dataLen Number of bytes to send.
+   * @param dataReverse Send bytes in reverse order.
+   * @param busStop Generate STOP after the last page.
+   * @return Result code.
    */
-  inline uint8_t getPinSCL() { return busStatus_.pinSCL; }
+  ResultCodes sendPages(Device &device,
+                        uint8_t *dataBuffer,
+                        uint16_t dataLen,
+                        bool dataReverse,
+                        bool busStop);
 
   /**
-   * @brief Get recent command sent to the bus.
-   * @return Last command value.
+   * @brief Send a register command with optional data to the I2C bus.
+   * @details The command is sent as one transmission ended by the requested
+   * condition, so that neither the page position nor the position bytes of
+   * a memory apply to it and a following busReceive() keeps the repeated
+   * START.
+   * @param dataBuffer Pointer to buffered command and data.
+   * @param dataLen Number of bytes to send.
+   * @return Result code.
    */
-  inline uint16_t getLastCommand() { return busStatus_.lastCommand; }
+  ResultCodes busSendCommand(uint8_t *dataBuffer, uint16_t dataLen);
 
   /**
-   * @brief Get bus clock frequency.
-   * @return Clock speed in Hz.
+   * @brief Decide about repeating a failed page of a device.
+   * @details Overflow of the transmit buffer is not transient, so that it is
+   * never repeated. A bus held by a device is recovered and the backoff is
+   * awaited before a repetition.
+   * @param device Device context.
+   * @param result Result code of the failed page.
+   * @param attempt Number of previous repetitions of the page.
+   * @return True if the page should be repeated.
    */
-  inline ClockSpeeds getBusClock() { return busStatus_.clock; }
+  bool retryPage(Device &device, ResultCodes result, uint8_t attempt);
 
   /**
-   * @brief Check if recent operation was successful.
-   * @details Evaluates the internally stored result code.
-   * @return True if the stored result code is SUCCESS, false otherwise.
+   * @brief Pin of the serial data line of the bus.
    */
-  inline bool isSuccess()
+  inline uint8_t getBusPinSDA()
   {
-    return busStatus_.lastResult == ResultCodes::SUCCESS;
+#if defined(__AVR__) || defined(PARTICLE)
+    return hasTransportPins(static_cast<Transport *>(this)) ? getPinSDA()
+                                                             : SDA;
+#else
+    return getPinSDA();
+#endif
   }
 
   /**
-   * @brief Check if a given result code indicates success.
-   * @details Evaluates the provided result code directly without modifying
-   * internal state. Useful for evaluating return values of inline methods
-   * directly in conditional expressions.
-   * @param lastResult Result code to evaluate.
-   * @return True if lastResult is SUCCESS, false otherwise.
+   * @brief Pin of the serial clock line of the bus.
    */
-  inline bool isSuccess(ResultCodes lastResult)
+  inline uint8_t getBusPinSCL()
   {
-    return lastResult == ResultCodes::SUCCESS;
+#if defined(__AVR__) || defined(PARTICLE)
+    return hasTransportPins(static_cast<Transport *>(this)) ? getPinSCL()
+                                                             : SCL;
+#else
+    return getPinSCL();
+#endif
   }
 
   /**
-   * @brief Check if recent operation resulted in an error.
-   * @details Evaluates the internally stored result code.
-   * @return True if the stored result code is not SUCCESS, false otherwise.
+   * @brief Release the bus held by repeated START after an aborted
+   * transfer.
+   * @details Addresses the device by an empty transmission with STOP.
    */
-  inline bool isError()
+  inline void releaseBus(uint8_t address)
   {
-    return !isSuccess();
+    beginTransmission(address);
+    endTransmission(true);
   }
 
   /**
-   * @brief Check if a given result code indicates an error.
-   * @details Evaluates the provided result code directly without modifying
-   * internal state. Useful for evaluating return values of inline methods
-   * directly in conditional expressions.
-   * @param lastResult Result code to evaluate.
-   * @return True if lastResult is not SUCCESS, false otherwise.
+   * @brief Send scattered byte stream to a device in pages.
+   * @details Paging counterpart of sendPages() for segments.
+   * @return Result code.
    */
-  inline bool isError(ResultCodes lastResult) { return !isSuccess(lastResult); }
-  /// @}
+  ResultCodes sendSegments(Device &device,
+                           Segment *segments,
+                           uint8_t count,
+                           bool busStop);
 
   /**
-   * @brief Convert error code to human-readable text.
-   * @param location Optional location string for error context.
-   * @return Formatted error message.
+   * @brief Receive scattered byte stream from a device in pages.
+   * @details Paging counterpart of receivePages() for segments.
+   * @return Result code.
    */
-  String getLastErrorTxt(String location = "");
+  ResultCodes receiveSegments(Device &device,
+                              Segment *segments,
+                              uint8_t count,
+                              bool busStop);
 
   /**
-   * @brief Set send operation delay.
-   * @details Delays before subsequent send after completion of previous send.
-   * @param delay Wait time in milliseconds.
+   * @brief Receive byte stream from a device in pages.
+   * @details Counterpart of sendPages() for reading.
+   * @return Result code.
    */
-  inline void setDelaySend(uint32_t delay) { busStatus_.sendDelay = delay; }
+  ResultCodes receivePages(Device &device,
+                           uint8_t *dataBuffer,
+                           uint16_t dataLen,
+                           bool dataReverse,
+                           bool busStop);
 
   /**
-   * @brief Get send operation delay.
-   * @return Delay in milliseconds.
+   * @brief Write a part of a byte stream to the transmit buffer.
+   * @details Forward stream is handed over to the buffer form of write() at
+   * once, reverse stream is staged in a page buffer first, so that there is
+   * neither a call nor a direction test per byte. Stream in program memory
+   * is staged in the page buffer by a block copy or by reading bytes in
+   * reverse order.
+   * @param dataBuffer Reference to pointer to the next byte of the stream,
+   * which is moved by the number of written bytes in the stream direction.
+   * @param dataLen Number of bytes to write, at most the bus buffer length.
+   * @param dataReverse Flag about stream in reverse order.
+   * @param dataProgmem Flag about stream in program memory.
    */
-  inline uint32_t getDelaySend() { return busStatus_.sendDelay; }
+  void writeStream(uint8_t *&dataBuffer,
+                   uint8_t dataLen,
+                   bool dataReverse,
+                   bool dataProgmem = false);
 
   /**
-   * @brief Set receive operation delay.
-   * @details Delays before subsequent receive after completion of previous
-   * receive.
-   * @param delay Wait time in milliseconds.
+   * @brief Read a part of a byte stream from the receive buffer.
+   * @details The page is copied at once where the transport provides a
+   * block read, otherwise by a loop with the direction test hoisted out of
+   * it. Reverse order is made by a single pass over the page.
+   * @param dataBuffer Reference to pointer to the next byte of the stream,
+   * which is moved by the number of read bytes in the stream direction.
+   * @param dataLen Number of bytes to read, at most the bus buffer length.
+   * @param dataReverse Flag about stream in reverse order.
    */
-  inline void setDelayReceive(uint32_t delay)
+  void readStream(uint8_t *&dataBuffer, uint8_t dataLen, bool dataReverse);
+
+  /// @name Stream packing by policy
+  /// @{
+  template<bool MsbFirst, bool AllBytes>
+  inline size_t writeData(uint16_t data, StreamPolicy<MsbFirst, AllBytes>)
+  {
+    uint8_t pageBuffer[2] = {
+      static_cast<uint8_t>(MsbFirst ? data >> 8 : data),
+      static_cast<uint8_t>(MsbFirst ? data : data >> 8),
+    };
+    // Zero first byte is skipped without a branch
+    uint8_t skip = !AllBytes && !pageBuffer[0];
+    return write(pageBuffer + skip, 2 - skip);
+  }
+  inline size_t writeData(uint16_t data, StreamRuntime)
+  {
+    uint8_t pageBuffer[2];
+    uint16_t dataLen = 0;
+    bufferData(pageBuffer, dataLen, data);
+    return write(pageBuffer, dataLen);
+  }
+  template<uint8_t Width, bool MsbFirst, bool AllBytes>
+  inline size_t writeData(Value<Width> data, StreamPolicy<MsbFirst, AllBytes>)
+  {
+    uint8_t pageBuffer[Width];
+    for (uint8_t i = 0; i < Width; i++)
+    {
+      pageBuffer[i] = data.value >> 8 * (MsbFirst ? Width - 1 - i : i);
+    }
+    return write(pageBuffer, Width);
+  }
+  template<uint8_t Width>
+  inline size_t writeData(Value<Width> data, StreamRuntime)
   {
-    busStatus_.receiveDelay = delay;
+    if (getStreamDir() == DataStreamProcessing::STREAM_DIR_MSB)
+    {
+      return writeData(data, StreamMsbAll());
+    }
+    else
+    {
+      return writeData(data, StreamLsbAll());
+    }
   }
+  /// @}
 
+  /// @name Compile time transfers
+  /// @{
   /**
-   * @brief Get receive operation delay.
-   * @return Delay in milliseconds.
+   * @brief Check if a fixed stream may be paged by the buffer length.
+   * @details Otherwise it is paged at runtime by the page length and
+   * boundary of the selected device.
    */
-  inline uint32_t getDelayReceive() { return busStatus_.receiveDelay; }
+  inline bool isPageFixed(uint16_t dataLen)
+  {
+    return !getDevice().pageBoundary && !getDevice().positionBytes &&
+           !getDevice().retries &&
+           (dataLen <= getDevice().pageLength ||
+            getDevice().pageLength == DataStreamProcessing::STREAM_BUFFER_LENGTH);
+  }
 
-private:
-  enum AddressRange : uint8_t
+  /// Tag selecting an overload by a compile time flag
+  template<bool Flag>
+  struct FixedTag
   {
-    /// Minimal valid address
-    ADDRESS_MIN = 0x00,
-    /// Maximal valid address
-    ADDRESS_MAX = 0x7F,
-    /// Minimal special purposes address
-    ADDRESS_MIN_SPECIAL = 0x01,
-    /// Minimal usual address
-    ADDRESS_MIN_USUAL = 0x03,
-    /// Maximal usual address
-    ADDRESS_MAX_USUAL = 0x77,
-    /// General call address
-    ADDRESS_GENCALL = 0x00,
   };
-
-  enum GeneralCall : uint8_t
+  /// Tag selecting an overload by a compile time length
+  template<uint8_t Len>
+  struct FixedLen
   {
-    /// Software reset and write programmable part of slave address
-    GENCALL_RESET = 0x06,
-    /// Write programmable part of slave address only
-    GENCALL_WRITE = 0x04,
   };
 
-  enum DataStreamProcessing : uint8_t
+  /**
+   * @brief Send the last or the only page of a fixed stream.
+   * @details Reverse stream is addressed by the pointer behind its first
+   * byte in the buffer, i.e., behind its last byte in memory.
+   */
+  template<uint16_t N, bool Reverse>
+  inline ResultCodes sendFixed(uint8_t *dataBuffer,
+                               bool busStop,
+                               FixedTag<true>)
   {
-    /// Process data stream with the least significant byte first
-    STREAM_DIR_LSB = 0,
-    /// Process data stream with the most significant byte first
-    STREAM_DIR_MSB = 1,
-    /// Process only non-zero bytes from LSB - ignore zero MSB bytes
-    STREAM_BYTES_VAL = 2,
-    /// Process all bytes of data stream regardless of their value
-    STREAM_BYTES_ALL = 3,
-    /// I2C Buffer length adopted from parent library
-    STREAM_BUFFER_LENGTH = BUFFER_LENGTH,
-  };
+    beginTransmission(getAddress());
+    writeFixed<N>(dataBuffer, FixedTag<Reverse>());
+    statPage(getDevice(), N, true, busStop);
+    return static_cast<ResultCodes>(endTransmission(busStop));
+  }
 
-  struct BusStatus
+  /**
+   * @brief Send a full page of a fixed stream and the rest after it with
+   * repeated START.
+   */
+  template<uint16_t N, bool Reverse>
+  inline ResultCodes sendFixed(uint8_t *dataBuffer,
+                               bool busStop,
+                               FixedTag<false>)
   {
-    /// Result of a recent operation
-    ResultCodes lastResult;
-    /// Command code recently sent to two-wire bus
-    uint16_t lastCommand;
-    /// Address of the device on two-wire bus
-    uint8_t address = 255;
-    /// Clock frequency in Hz
-    ClockSpeeds clock;
-    /// Flag about releasing bus after end of transmission
-    bool busStop;
-    /// Pin for serial data
-    uint8_t pinSDA;
-    /// Pin for serial clock
-    uint8_t pinSCL;
-    /// Mode of data stream processing
-    uint8_t streamDirection;
-    /// Mode of data stream bytes processing
-    uint8_t streamBytes;
-    /// Waiting after each sent page
-    uint32_t sendDelay = 0;
-    /// Waiting after each received page
-    uint32_t receiveDelay = 0;
-    /// Recent bus transmission timestamp
-    uint32_t transTimestamp = 0;
-#if defined(__AVR__) || defined(ESP8266) || defined(ESP32)
-    bool busEnabled; // Flag about bus initialization
-#endif
-  } busStatus_; /// Microcontroller status features
+    const uint8_t pageLen = DataStreamProcessing::STREAM_BUFFER_LENGTH;
+    ResultCodes result = sendFixed<pageLen, Reverse>(
+      Reverse ? dataBuffer + N - pageLen : dataBuffer, false, FixedTag<true>());
+    if (isError(result))
+    {
+      return result;
+    }
+    return sendFixed<N - pageLen, Reverse>(
+      Reverse ? dataBuffer : dataBuffer + pageLen,
+      busStop,
+      FixedTag<(N - pageLen <= pageLen)>());
+  }
+
+  template<uint8_t Len>
+  inline void writeFixed(uint8_t *dataBuffer, FixedTag<false>)
+  {
+    write(dataBuffer, Len);
+  }
+  template<uint8_t Len>
+  inline void writeFixed(uint8_t *dataBuffer, FixedTag<true>)
+  {
+    uint8_t pageBuffer[Len];
+    copyReverse(pageBuffer, dataBuffer + Len, FixedLen<Len>());
+    write(pageBuffer, Len);
+  }
+
+  template<uint8_t Len>
+  inline void copyReverse(uint8_t *target, uint8_t *sourceEnd, FixedLen<Len>)
+  {
+    *target = *(sourceEnd - 1);
+    copyReverse(target + 1, sourceEnd - 1, FixedLen<Len - 1>());
+  }
+  inline void copyReverse(uint8_t *, uint8_t *, FixedLen<0>) {}
 
   /**
-   * @brief Set recent command sent to bus.
-   * @param lastCommand Command value.
-   * @return The command value.
+   * @brief Receive the last or the only page of a fixed stream.
    */
-  inline uint16_t setLastCommand(uint16_t lastCommand)
+  template<uint16_t N, bool Reverse>
+  inline ResultCodes receiveFixed(uint8_t *dataBuffer,
+                                  bool busStop,
+                                  FixedTag<true>)
   {
-    return busStatus_.lastCommand = lastCommand;
+    if (requestFrom(getAddress(),
+                    static_cast<uint8_t>(N),
+                    static_cast<uint8_t>(busStop)) == 0 ||
+        available() < static_cast<int>(N))
+    {
+      return ResultCodes::ERROR_RCV_DATA;
+    }
+    statPage(getDevice(), N, false, busStop);
+    readFixed(Reverse ? dataBuffer + N - 1 : dataBuffer,
+              FixedTag<Reverse>(),
+              FixedLen<N>());
+    return ResultCodes::SUCCESS;
   }
 
   /**
-   * @brief Buffer data word according to stream settings.
-   * @details Updates buffer from index with data according to stream direction
-   * and byte processing modes, and advances index.
-   * @param dataBuffer Pointer to byte buffer to update.
-   * @param dataIdx Reference to buffer index (will be incremented).
-   * @param data Data word to buffer.
+   * @brief Receive a full page of a fixed stream and the rest after it with
+   * repeated START.
    */
-  inline void bufferData(uint8_t *dataBuffer, uint16_t &dataIdx, uint16_t data)
+  template<uint16_t N, bool Reverse>
+  inline ResultCodes receiveFixed(uint8_t *dataBuffer,
+                                  bool busStop,
+                                  FixedTag<false>)
   {
-    uint8_t dataLSB = data & 0xFF;
-    uint8_t dataMSB = (data >> 8) & 0xFF;
-    switch (getStreamDir())
+    const uint8_t pageLen = DataStreamProcessing::STREAM_BUFFER_LENGTH;
+    ResultCodes result = receiveFixed<pageLen, Reverse>(
+      Reverse ? dataBuffer + N - pageLen : dataBuffer, false, FixedTag<true>());
+    if (isError(result))
     {
-      case DataStreamProcessing::STREAM_DIR_MSB:
-        if ((getStreamBytes() == DataStreamProcessing::STREAM_BYTES_ALL) ||
-            dataMSB)
-        {
-          dataBuffer[dataIdx++] = dataMSB;
-        }
-        dataBuffer[dataIdx++] = dataLSB;
-        break;
-      case DataStreamProcessing::STREAM_DIR_LSB:
-      default:
-        if ((getStreamBytes() == DataStreamProcessing::STREAM_BYTES_ALL) ||
-            dataLSB)
-        {
-          dataBuffer[dataIdx++] = dataLSB;
-        }
-        dataBuffer[dataIdx++] = dataMSB;
-        break;
+      return result;
     }
+    return receiveFixed<N - pageLen, Reverse>(
+      Reverse ? dataBuffer : dataBuffer + pageLen,
+      busStop,
+      FixedTag<(N - pageLen <= pageLen)>());
+  }
+
+  template<bool Reverse, uint8_t Len>
+  inline void readFixed(uint8_t *dataBuffer, FixedTag<Reverse>, FixedLen<Len>)
+  {
+    *dataBuffer = read();
+    readFixed(Reverse ? dataBuffer - 1 : dataBuffer + 1,
+              FixedTag<Reverse>(),
+              FixedLen<Len - 1>());
+  }
+  template<bool Reverse>
+  inline void readFixed(uint8_t *, FixedTag<Reverse>, FixedLen<0>)
+  {
   }
+  /// @}
 
 protected:
   /// @name Bus state management
@@ -664,14 +2545,14 @@ protected:
    * @brief Get current data stream direction setting.
    * @return Stream direction mode.
    */
-  inline uint8_t getStreamDir() { return busStatus_.streamDirection; }
+  inline uint8_t getStreamDir() { return getDevice().streamDirection; }
 
   /**
    * @brief Set data stream direction to LSB first.
    */
   inline void setStreamDirLSB()
   {
-    busStatus_.streamDirection = DataStreamProcessing::STREAM_DIR_LSB;
+    getDevice().streamDirection = DataStreamProcessing::STREAM_DIR_LSB;
   }
 
   /**
@@ -679,7 +2560,7 @@ protected:
    */
   inline void setStreamDirMSB()
   {
-    busStatus_.streamDirection = DataStreamProcessing::STREAM_DIR_MSB;
+    getDevice().streamDirection = DataStreamProcessing::STREAM_DIR_MSB;
   }
 
   /**
@@ -694,14 +2575,14 @@ protected:
    * @brief Get current byte processing mode.
    * @return Byte processing mode.
    */
-  inline uint8_t getStreamBytes() { return busStatus_.streamBytes; }
+  inline uint8_t getStreamBytes() { return getDevice().streamBytes; }
 
   /**
    * @brief Set byte processing to value-based (skip zero MSB).
    */
   inline void setStreamBytesVal()
   {
-    busStatus_.streamBytes = DataStreamProcessing::STREAM_BYTES_VAL;
+    getDevice().streamBytes = DataStreamProcessing::STREAM_BYTES_VAL;
   }
 
   /**
@@ -709,7 +2590,7 @@ protected:
    */
   inline void setStreamBytesAll()
   {
-    busStatus_.streamBytes = DataStreamProcessing::STREAM_BYTES_ALL;
+    getDevice().streamBytes = DataStreamProcessing::STREAM_BYTES_ALL;
   }
 
   /**
@@ -722,36 +2603,82 @@ protected:
   /// @{
   /**
    * @brief Set transmission timestamp.
+   * @details The microsecond timestamp is set correspondingly.
    * @param timestamp Optional custom timestamp (default: current millis()).
    */
   inline void setTimestamp(uint32_t timestamp = millis())
   {
-    busStatus_.transTimestamp = timestamp;
+    getDevice().transTimestampUs = micros() - 1000 * (millis() - timestamp);
+    getDevice().transTimestamp = timestamp;
   }
 
   /**
    * @brief Get recent transmission timestamp.
    * @return Timestamp in milliseconds.
    */
-  inline uint32_t getTimestamp() { return busStatus_.transTimestamp; }
+  inline uint32_t getTimestamp() { return getDevice().transTimestamp; }
+
+  /**
+   * @brief Get recent transmission timestamp in microseconds.
+   * @return Timestamp in microseconds.
+   */
+  inline uint32_t getTimestampUs() { return getDevice().transTimestampUs; }
+
+  /**
+   * @brief Check without waiting if send delay has expired.
+   * @param device Device context (default: selected one).
+   * @return True if a send may start.
+   */
+  inline bool isTimestampSend(Device &device)
+  {
+    return isDelayExpired(device, device.sendDelay, device.sendDelayUs);
+  }
+  inline bool isTimestampSend() { return isTimestampSend(getDevice()); }
+
+  /**
+   * @brief Check without waiting if receive delay has expired.
+   * @param device Device context (default: selected one).
+   * @return True if a receive may start.
+   */
+  inline bool isTimestampReceive(Device &device)
+  {
+    return isDelayExpired(device, device.receiveDelay, device.receiveDelayUs);
+  }
+  inline bool isTimestampReceive() { return isTimestampReceive(getDevice()); }
 
   /**
    * @brief Wait until send delay expires.
+   * @param device Device context (default: selected one).
    */
-  inline void waitTimestampSend()
+  inline void waitTimestampSend(Device &device)
   {
-    while (millis() - busStatus_.transTimestamp < getDelaySend())
+#if defined(GBJ_TWOWIRE_STATS)
+    uint32_t timestamp = micros();
+#endif
+    while (!isTimestampSend(device))
       ;
+#if defined(GBJ_TWOWIRE_STATS)
+    device.stats.waitUs += micros() - timestamp;
+#endif
   }
+  inline void waitTimestampSend() { waitTimestampSend(getDevice()); }
 
   /**
    * @brief Wait until receive delay expires.
+   * @param device Device context (default: selected one).
    */
-  inline void waitTimestampReceive()
+  inline void waitTimestampReceive(Device &device)
   {
-    while (millis() - busStatus_.transTimestamp < getDelayReceive())
+#if defined(GBJ_TWOWIRE_STATS)
+    uint32_t timestamp = micros();
+#endif
+    while (!isTimestampReceive(device))
       ;
+#if defined(GBJ_TWOWIRE_STATS)
+    device.stats.waitUs += micros() - timestamp;
+#endif
   }
+  inline void waitTimestampReceive() { waitTimestampReceive(getDevice()); }
   /// @}
 
   /**
@@ -768,6 +2695,62 @@ protected:
     }
   }
 
+  /**
+   * @brief Wait for specified duration in microseconds.
+   * @details Blocking delay using polling, wraparound safe.
+   * @param delay Wait time in microseconds.
+   */
+  inline void waitUs(uint32_t delay)
+  {
+    uint32_t timestamp = micros();
+    while (micros() - timestamp < delay)
+    {
+      ;
+    }
+  }
+
+  /**
+   * @brief Flag about a transport started on the pins of the driver.
+   */
+  template<typename T>
+  static inline auto hasTransportPins(T *transport)
+    -> decltype(transport->begin(0, 0), true)
+  {
+    return true;
+  }
+  static inline bool hasTransportPins(...) { return false; }
+
+  /**
+   * @brief Flag about a transport copying received bytes by readBytes() at
+   * once.
+   * @details It is gbj_twowire_bitbang and TwoWire of the host simulation.
+   * Stream::readBytes() of Arduino and Particle cores waits for every byte
+   * by timedRead(), which calls millis() per byte, so that their TwoWire is
+   * read by the plain read() loop.
+   */
+  static inline bool isBlockRead(gbj_twowire_bitbang *) { return true; }
+#if defined(GBJ_TWOWIRE_SIM)
+  static inline bool isBlockRead(TwoWire *) { return true; }
+#endif
+  static inline bool isBlockRead(...) { return false; }
+
+  /**
+   * @brief Start the transport on the pins, if it supports them.
+   * @details Selected at compile time by the signature of the transport,
+   * e.g., the TwoWire library of ESP cores or gbj_twowire_bitbang.
+   */
+  template<typename T>
+  inline auto beginTransport(T *transport)
+    -> decltype(transport->begin(0, 0), void())
+  {
+    transport->T::begin(busStatus_.pinSDA, busStatus_.pinSCL);
+  }
+
+  /**
+   * @brief Start the transport on its default pins.
+   */
+  inline void beginTransport(...) { Transport::begin(); }
+
   /**
    * @brief Initialize two-wire bus if not already initialized.
    * @details Starts bus and sets platform-specific configuration.
@@ -775,22 +2758,17 @@ protected:
   inline void initBus()
   {
     setLastResult();
-#if defined(__AVR__)
-    if (!busStatus_.busEnabled)
-    {
-      Wire.begin();
-      busStatus_.busEnabled = true;
-    }
-#elif defined(ESP8266) || defined(ESP32)
+#if defined(__AVR__) || defined(ESP8266) || defined(ESP32) ||                \
+  defined(GBJ_TWOWIRE_SIM)
     if (!busStatus_.busEnabled)
     {
-      Wire.begin(busStatus_.pinSDA, busStatus_.pinSCL);
+      beginTransport(static_cast<Transport *>(this));
       busStatus_.busEnabled = true;
     }
 #elif defined(PARTICLE)
     if (!isEnabled())
     {
-      Wire.begin();
+      beginTransport(static_cast<Transport *>(this));
     }
 #endif
     setBusClock(getBusClock());
@@ -0,0 +1,332 @@
+#include "gbj_twowire.h"
+
+void gbj_twowire_bitbang::begin()
+{
+  begin(sda_.pin, scl_.pin);
+}
+
+void gbj_twowire_bitbang::begin(int pinSDA, int pinSCL)
+{
+  // Both lines on one pin, e.g., no pins started before, are rejected
+  if (pinSDA == pinSCL)
+  {
+    end();
+    return;
+  }
+#if defined(GBJ_TWOWIRE_SIM)
+  SimBus.setPins(pinSDA, pinSCL);
+#endif
+  initLine(sda_, pinSDA);
+  initLine(scl_, pinSCL);
+  txLength_ = rxLength_ = rxIndex_ = 0;
+  setClock(100000);
+  enabled_ = true;
+}
+
+void gbj_twowire_bitbang::end()
+{
+  if (!enabled_)
+  {
+    return;
+  }
+  pinMode(sda_.pin, INPUT);
+  pinMode(scl_.pin, INPUT);
+  enabled_ = false;
+}
+
+void gbj_twowire_bitbang::setClock(uint32_t clock)
+{
+  if (clock == 0)
+  {
+    return;
+  }
+  if (clock > Timing::CLOCK_MAX)
+  {
+    clock = Timing::CLOCK_MAX;
+  }
+  // Minimal clock low and high time of the bus mode in nanoseconds
+  uint32_t lowMinNs = clock > 400000 ? 500 : clock > 100000 ? 1300 : 4700;
+  uint32_t highMinNs = clock > 400000 ? 260 : clock > 100000 ? 600 : 4000;
+  uint32_t periodNs = 1000000000UL / clock;
+  loopsHigh_ = getLoops(static_cast<uint64_t>(periodNs) * highMinNs /
+                        (lowMinNs + highMinNs));
+  uint32_t highNs = 2 * Timing::PIN_NS + loopsHigh_ * Timing::LOOP_NS;
+  loopsLow_ =
+    getLoops(periodNs > highNs + lowMinNs ? periodNs - highNs : lowMinNs);
+}
+
+uint16_t gbj_twowire_bitbang::getLoops(uint32_t nanos)
+{
+  uint32_t pinsNs = 2 * Timing::PIN_NS;
+  if (nanos <= pinsNs)
+  {
+    return 0;
+  }
+  uint32_t loops = (nanos - pinsNs + Timing::LOOP_NS - 1) / Timing::LOOP_NS;
+  return loops > 0xFFFF ? 0xFFFF : loops;
+}
+
+GBJ_TWOWIRE_BITBANG_INLINE bool gbj_twowire_bitbang::writeByte(uint8_t data)
+{
+  for (uint8_t mask = 0x80; mask; mask >>= 1)
+  {
+    if (data & mask)
+    {
+      releaseLine(sda_);
+    }
+    else
+    {
+      lowLine(sda_);
+    }
+    waitLow();
+    if (!raiseSCL())
+    {
+      return false;
+    }
+    waitHigh();
+    lowLine(scl_);
+  }
+  // Acknowledge bit driven by the device
+  releaseLine(sda_);
+  waitLow();
+  if (!raiseSCL())
+  {
+    return false;
+  }
+  bool ack = !readLine(sda_);
+  waitHigh();
+  lowLine(scl_);
+  return ack;
+}
+
+GBJ_TWOWIRE_BITBANG_INLINE uint8_t gbj_twowire_bitbang::readByte(bool ack)
+{
+  uint8_t data = 0;
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    // Data line released in the low time of every bit, which keeps its pin
+    // accesses equal to writing
+    releaseLine(sda_);
+    waitLow();
+    if (!raiseSCL())
+    {
+      return data;
+    }
+    data = (data << 1) | readLine(sda_);
+    waitHigh();
+    lowLine(scl_);
+  }
+  // Acknowledge bit driven by the master
+  if (ack)
+  {
+    lowLine(sda_);
+  }
+  else
+  {
+    releaseLine(sda_);
+  }
+  waitLow();
+  if (!raiseSCL())
+  {
+    return data;
+  }
+  waitHigh();
+  lowLine(scl_);
+  releaseLine(sda_);
+  return data;
+}
+
+void gbj_twowire_bitbang::beginTransmission(uint8_t address)
+{
+  txAddress_ = address;
+  txLength_ = 0;
+  txOverflow_ = false;
+}
+
+uint8_t gbj_twowire_bitbang::endTransmission(uint8_t sendStop)
+{
+  uint8_t txLength = txLength_;
+  txLength_ = 0;
+  if (txOverflow_)
+  {
+    txOverflow_ = false;
+    return 1;
+  }
+  if (!enabled_ || !start())
+  {
+    return 4;
+  }
+  uint8_t result = writeByte(txAddress_ << 1) ? 0 : 2;
+  // Burst of data bytes with inlined bit loops
+  for (uint8_t i = 0; result == 0 && i < txLength; i++)
+  {
+    if (!writeByte(txBuffer_[i]))
+    {
+      result = 3;
+    }
+  }
+  if (aborted_)
+  {
+    return 4;
+  }
+  if (result || sendStop)
+  {
+    stop();
+  }
+  return result;
+}
+
+uint8_t gbj_twowire_bitbang::requestFrom(uint8_t address,
+                                         uint8_t quantity,
+                                         uint8_t sendStop)
+{
+  rxIndex_ = rxLength_ = 0;
+  if (quantity >= GBJ_TWOWIRE_BUFFER_LENGTH)
+  {
+    quantity = GBJ_TWOWIRE_BUFFER_LENGTH;
+  }
+  if (!enabled_ || !start())
+  {
+    return 0;
+  }
+  if (!writeByte((address << 1) | 1))
+  {
+    if (!aborted_)
+    {
+      stop();
+    }
+    return 0;
+  }
+  // The last byte is not acknowledged
+  for (uint8_t i = 0; i < quantity; i++)
+  {
+    rxBuffer_[i] = readByte(i + 1 < quantity);
+    if (aborted_)
+    {
+      return 0;
+    }
+  }
+  if (sendStop)
+  {
+    stop();
+  }
+  rxLength_ = quantity;
+  return quantity;
+}
+
+size_t gbj_twowire_bitbang::write(uint8_t data)
+{
+  if (txLength_ >= GBJ_TWOWIRE_BUFFER_LENGTH)
+  {
+    txOverflow_ = true;
+    return 0;
+  }
+  txBuffer_[txLength_++] = data;
+  return 1;
+}
+
+size_t gbj_twowire_bitbang::write(const uint8_t *data, size_t quantity)
+{
+  if (quantity > static_cast<size_t>(GBJ_TWOWIRE_BUFFER_LENGTH - txLength_))
+  {
+    quantity = GBJ_TWOWIRE_BUFFER_LENGTH - txLength_;
+    txOverflow_ = true;
+  }
+  memcpy(txBuffer_ + txLength_, data, quantity);
+  txLength_ += quantity;
+  return quantity;
+}
+
+size_t gbj_twowire_bitbang::readBytes(uint8_t *buffer, size_t length)
+{
+  if (length > static_cast<size_t>(available()))
+  {
+    length = available();
+  }
+  memcpy(buffer, rxBuffer_ + rxIndex_, length);
+  rxIndex_ += length;
+  return length;
+}
+
+void gbj_twowire_bitbang::initLine(Line &line, uint8_t pin)
+{
+  line.pin = pin;
+#if defined(__AVR__)
+  uint8_t port = digitalPinToPort(pin);
+  line.mask = digitalPinToBitMask(pin);
+  line.mode = portModeRegister(port);
+  line.input = portInputRegister(port);
+  // Input without pull-up clears the output latch
+  pinMode(pin, INPUT);
+#elif defined(OUTPUT_OPEN_DRAIN)
+  digitalWrite(pin, HIGH);
+  pinMode(pin, OUTPUT_OPEN_DRAIN);
+#else
+  pinMode(pin, INPUT);
+  digitalWrite(pin, LOW);
+#endif
+}
+
+bool gbj_twowire_bitbang::waitStretch()
+{
+  uint32_t timestamp = micros();
+  while (!readLine(scl_))
+  {
+    if (timeoutUs_ && micros() - timestamp >= timeoutUs_)
+    {
+      abort();
+      return false;
+    }
+  }
+  // Confirming read takes place of the releasing access in the high time
+  readLine(scl_);
+  return true;
+}
+
+void gbj_twowire_bitbang::abort()
+{
+  aborted_ = timeoutFlag_ = true;
+  releaseLine(sda_);
+  releaseLine(scl_);
+  if (timeoutReset_)
+  {
+    initLine(sda_, sda_.pin);
+    initLine(scl_, scl_.pin);
+  }
+}
+
+bool gbj_twowire_bitbang::start()
+{
+  aborted_ = false;
+  // Bus free time or repeated START setup with both lines released
+  releaseLine(sda_);
+  waitLow();
+  if (!raiseSCL())
+  {
+    return false;
+  }
+  waitLow();
+  if (!readLine(sda_))
+  {
+    return false;
+  }
+  // START as falling data line while the clock line is high
+  lowLine(sda_);
+  waitHigh();
+  lowLine(scl_);
+  return true;
+}
+
+void gbj_twowire_bitbang::stop()
+{
+  lowLine(sda_);
+  waitLow();
+  if (!raiseSCL())
+  {
+    return;
+  }
+  waitHigh();
+  // STOP as rising data line while the clock line is high
+  releaseLine(sda_);
+  waitLow();
+}
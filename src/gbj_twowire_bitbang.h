@@ -0,0 +1,279 @@
+/**
+ * @file gbj_twowire_bitbang.h
+ * @brief Software (bit-banged) two-wire transport.
+ * @details Provides the subset of the TwoWire interface used by gbjTwoWire
+ * library on any two general purpose pins, so that it can be selected as
+ * the transport of the library by the macro GBJ_TWOWIRE_TRANSPORT, e.g., on
+ * pins without a two-wire peripheral or for a second bus.
+ * The lines are driven in open drain manner, i.e., pulled low as outputs and
+ * released as inputs. External pull-up resistors are expected.
+ * Bit timing is generated by a calibrated delay loop up to Fast-mode Plus
+ * (1 MHz), pin access and bit loops are inlined into the byte loops.
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the MIT License (MIT).
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_twowire.git
+ */
+#ifndef GBJ_TWOWIRE_BITBANG_H
+#define GBJ_TWOWIRE_BITBANG_H
+
+#if defined(F_CPU)
+  #define GBJ_TWOWIRE_BITBANG_CPU F_CPU
+#else
+  /// Processor clock of cores not defining it, e.g., Particle Photon
+  #define GBJ_TWOWIRE_BITBANG_CPU 120000000UL
+#endif
+#ifndef GBJ_TWOWIRE_BITBANG_PIN_CYCLES
+  /// Processor cycles of a pin access
+  #if defined(__AVR__)
+    #define GBJ_TWOWIRE_BITBANG_PIN_CYCLES 5
+  #elif defined(GBJ_TWOWIRE_SIM)
+    #define GBJ_TWOWIRE_BITBANG_PIN_CYCLES 2
+  #else
+    #define GBJ_TWOWIRE_BITBANG_PIN_CYCLES 40
+  #endif
+#endif
+#ifndef GBJ_TWOWIRE_BITBANG_LOOP_CYCLES
+  /// Processor cycles of an iteration of the delay loop
+  #if defined(__AVR__)
+    #define GBJ_TWOWIRE_BITBANG_LOOP_CYCLES 5
+  #else
+    #define GBJ_TWOWIRE_BITBANG_LOOP_CYCLES 4
+  #endif
+#endif
+#if defined(__GNUC__)
+  #define GBJ_TWOWIRE_BITBANG_INLINE inline __attribute__((always_inline))
+#else
+  #define GBJ_TWOWIRE_BITBANG_INLINE inline
+#endif
+
+/**
+ * @class gbj_twowire_bitbang
+ * @brief Master of the two-wire bus bit-banged on general purpose pins.
+ * @details Transmission is buffered up to GBJ_TWOWIRE_BUFFER_LENGTH bytes
+ * and put on the bus at endTransmission(), reception is limited to that
+ * length per request, as in the AVR TwoWire library, and result codes of
+ * endTransmission() are the same.
+ * Devices may stretch the clock line at any bit. Waiting for its release is
+ * limited by the timeout, after which the transaction is aborted with both
+ * lines released.
+ */
+class gbj_twowire_bitbang
+{
+public:
+  enum Timing : uint32_t
+  {
+    /// Maximal clock frequency in Hz (Fast-mode Plus)
+    CLOCK_MAX = 1000000UL,
+    /// Time of a pin access in nanoseconds
+    PIN_NS = 1000UL * GBJ_TWOWIRE_BITBANG_PIN_CYCLES /
+             (GBJ_TWOWIRE_BITBANG_CPU / 1000000UL),
+    /// Time of an iteration of the delay loop in nanoseconds
+    LOOP_NS = 1000UL * GBJ_TWOWIRE_BITBANG_LOOP_CYCLES /
+              (GBJ_TWOWIRE_BITBANG_CPU / 1000000UL),
+    /// Default timeout of clock stretching in microseconds
+    TIMEOUT_US = 25000UL,
+  };
+
+  /**
+   * @brief Start the bus again on the pins of the recent begin(pinSDA,
+   * pinSCL).
+   * @details The bus stays disabled if it has not been started on pins yet,
+   * since the pins of the two-wire peripheral are not macros on every
+   * platform, e.g., AVR.
+   */
+  void begin();
+
+  /**
+   * @brief Start the bus on the pins at the clock of 100 kHz.
+   * @details The same pin for both lines is rejected, so that the bus stays
+   * disabled and transfers fail as with an error other than NACK.
+   * @param pinSDA Pin of the serial data line.
+   * @param pinSCL Pin of the serial clock line.
+   */
+  void begin(int pinSDA, int pinSCL);
+
+  /**
+   * @brief Release the bus lines.
+   */
+  void end();
+
+  /**
+   * @brief Set clock frequency of the bus.
+   * @details The clock period is split into low and high time in the ratio
+   * of their minimums for the bus mode (Standard-mode, Fast-mode, or
+   * Fast-mode Plus) of the frequency, the low time being at least its
+   * minimum. Either time is generated by the delay loop reduced by the time
+   * of two pin accesses, which it contains, and rounded up to whole loop
+   * iterations, so that the clock never exceeds the frequency. Frequencies
+   * above Fast-mode Plus are limited to it.
+   * @param clock Frequency in Hz.
+   */
+  void setClock(uint32_t clock);
+  inline void setSpeed(uint32_t clock) { setClock(clock); }
+  inline bool isEnabled() { return enabled_; }
+
+  /**
+   * @brief Set timeout of clock stretching.
+   * @param timeout Timeout in microseconds, zero for waiting forever.
+   * @param reset Flag about releasing the bus lines and restarting the bus
+   * after a timeout, otherwise the lines are released only.
+   */
+  inline void setWireTimeout(uint32_t timeout = TIMEOUT_US, bool reset = false)
+  {
+    timeoutUs_ = timeout;
+    timeoutReset_ = reset;
+  }
+  inline bool getWireTimeoutFlag() { return timeoutFlag_; }
+  inline void clearWireTimeoutFlag() { timeoutFlag_ = false; }
+
+  void beginTransmission(uint8_t address);
+  inline void beginTransmission(int address)
+  {
+    beginTransmission(static_cast<uint8_t>(address));
+  }
+  uint8_t endTransmission(uint8_t sendStop = true);
+  uint8_t requestFrom(uint8_t address,
+                      uint8_t quantity,
+                      uint8_t sendStop = true);
+  inline uint8_t requestFrom(int address, int quantity, int sendStop = true)
+  {
+    return requestFrom(static_cast<uint8_t>(address),
+                       static_cast<uint8_t>(quantity),
+                       static_cast<uint8_t>(sendStop));
+  }
+
+  size_t write(uint8_t data);
+  size_t write(const uint8_t *data, size_t quantity);
+  inline int available() { return rxLength_ - rxIndex_; }
+  inline int read() { return rxIndex_ < rxLength_ ? rxBuffer_[rxIndex_++] : -1; }
+  inline int peek() { return rxIndex_ < rxLength_ ? rxBuffer_[rxIndex_] : -1; }
+  inline void flush() {}
+  size_t readBytes(uint8_t *buffer, size_t length);
+
+private:
+  struct Line
+  {
+#if defined(__AVR__)
+    volatile uint8_t *mode;
+    volatile uint8_t *input;
+    uint8_t mask;
+#endif
+    uint8_t pin;
+  };
+
+  Line sda_ = Line();
+  Line scl_ = Line();
+  uint16_t loopsLow_ = 0;
+  uint16_t loopsHigh_ = 0;
+  bool enabled_ = false;
+  bool aborted_ = false;
+  bool timeoutFlag_ = false;
+  bool timeoutReset_ = false;
+  uint32_t timeoutUs_ = TIMEOUT_US;
+  uint8_t txAddress_ = 0;
+  uint8_t txBuffer_[GBJ_TWOWIRE_BUFFER_LENGTH];
+  uint8_t txLength_ = 0;
+  bool txOverflow_ = false;
+  uint8_t rxBuffer_[GBJ_TWOWIRE_BUFFER_LENGTH];
+  uint8_t rxLength_ = 0;
+  uint8_t rxIndex_ = 0;
+
+  /// @name Bus conditions
+  /// @{
+  /**
+   * @brief Generate START or repeated START.
+   * @return False if the data line is held low, i.e., arbitration is lost,
+   * or the clock line is stretched over the timeout.
+   */
+  bool start();
+  void stop();
+  /**
+   * @brief Write a byte.
+   * @return True at ACK, false at NACK or abort.
+   */
+  GBJ_TWOWIRE_BITBANG_INLINE bool writeByte(uint8_t data);
+  GBJ_TWOWIRE_BITBANG_INLINE uint8_t readByte(bool ack);
+  /**
+   * @brief Release the clock line and wait for its rising edge.
+   * @return False if the clock line is stretched over the timeout.
+   */
+  GBJ_TWOWIRE_BITBANG_INLINE bool raiseSCL()
+  {
+    releaseLine(scl_);
+    return readLine(scl_) || waitStretch();
+  }
+  bool waitStretch();
+  void abort();
+  /// @}
+
+  /// @name Open drain lines
+  /// @{
+  void initLine(Line &line, uint8_t pin);
+#if defined(__AVR__)
+  // Output latch is kept low, so that the direction drives the line alone;
+  // the port direction must not be modified in interrupt routines
+  GBJ_TWOWIRE_BITBANG_INLINE void lowLine(Line &line)
+  {
+    *line.mode |= line.mask;
+  }
+  GBJ_TWOWIRE_BITBANG_INLINE void releaseLine(Line &line)
+  {
+    *line.mode &= ~line.mask;
+  }
+  GBJ_TWOWIRE_BITBANG_INLINE bool readLine(Line &line)
+  {
+    return *line.input & line.mask;
+  }
+#elif defined(OUTPUT_OPEN_DRAIN)
+  GBJ_TWOWIRE_BITBANG_INLINE void lowLine(Line &line)
+  {
+    digitalWrite(line.pin, LOW);
+  }
+  GBJ_TWOWIRE_BITBANG_INLINE void releaseLine(Line &line)
+  {
+    digitalWrite(line.pin, HIGH);
+  }
+  GBJ_TWOWIRE_BITBANG_INLINE bool readLine(Line &line)
+  {
+    return digitalRead(line.pin) == HIGH;
+  }
+#else
+  GBJ_TWOWIRE_BITBANG_INLINE void lowLine(Line &line)
+  {
+    pinMode(line.pin, OUTPUT);
+  }
+  GBJ_TWOWIRE_BITBANG_INLINE void releaseLine(Line &line)
+  {
+    pinMode(line.pin, INPUT);
+  }
+  GBJ_TWOWIRE_BITBANG_INLINE bool readLine(Line &line)
+  {
+    return digitalRead(line.pin) == HIGH;
+  }
+#endif
+  /// @}
+
+  /// @name Bit timing
+  /// @{
+  static uint16_t getLoops(uint32_t nanos);
+  GBJ_TWOWIRE_BITBANG_INLINE void wait(uint16_t loops)
+  {
+#if defined(GBJ_TWOWIRE_SIM)
+    // Delay loop on the simulated core
+    SimBus.advance(static_cast<uint64_t>(loops) * LOOP_NS);
+#else
+    for (; loops; loops--)
+    {
+      __asm__ __volatile__("nop");
+    }
+#endif
+  }
+  GBJ_TWOWIRE_BITBANG_INLINE void waitLow() { wait(loopsLow_); }
+  GBJ_TWOWIRE_BITBANG_INLINE void waitHigh() { wait(loopsHigh_); }
+  /// @}
+};
+
+#endif
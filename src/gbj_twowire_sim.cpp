@@ -0,0 +1,660 @@
+#include "gbj_twowire.h"
+#if defined(GBJ_TWOWIRE_SIM)
+  #include <stdio.h>
+  #include <string.h>
+
+gbj_twowire_sim_bus SimBus;
+TwoWire Wire;
+HardwareSerial Serial;
+
+uint32_t millis()
+{
+  return SimBus.millis();
+}
+
+uint32_t micros()
+{
+  return SimBus.micros();
+}
+
+void delay(uint32_t ms)
+{
+  SimBus.advance(1000000ULL * ms);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+  SimBus.advance(1000ULL * us);
+}
+
+// Pins of bus lines are open drain driven low by output low level only
+static uint8_t pinModes[256];
+static uint8_t pinValues[256];
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  pinModes[pin] = mode;
+  SimBus.drive(pin, mode == OUTPUT && pinValues[pin] == LOW);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  pinValues[pin] = value;
+  SimBus.drive(pin, pinModes[pin] == OUTPUT && value == LOW);
+}
+
+int digitalRead(uint8_t pin)
+{
+  return SimBus.level(pin) ? HIGH : LOW;
+}
+
+String::String(double value, uint8_t decimals)
+{
+  char text[32];
+  snprintf(text, sizeof(text), "%.*f", decimals, value);
+  str_ = text;
+}
+
+std::string String::toText(unsigned long value, uint8_t base, bool negative)
+{
+  const char *digits = "0123456789ABCDEF";
+  std::string text;
+  base = (base < 2 || base > 16) ? DEC : base;
+  do
+  {
+    text.insert(text.begin(), digits[value % base]);
+    value /= base;
+  } while (value);
+  if (negative)
+  {
+    text.insert(text.begin(), '-');
+  }
+  return text;
+}
+
+size_t HardwareSerial::print(const String &text)
+{
+  return fwrite(text.c_str(), 1, text.length(), stdout);
+}
+
+bool gbj_twowire_sim_memory::onAddress(bool read)
+{
+  // Busy with write cycle
+  if (SimBus.getNanos() < busyUntil_)
+  {
+    return false;
+  }
+  if (!read)
+  {
+    pointerIdx_ = 0;
+  }
+  return true;
+}
+
+bool gbj_twowire_sim_memory::onWrite(uint8_t data)
+{
+  if (pointerIdx_ < pointerBytes_)
+  {
+    pointer_ = pointerIdx_ ? (pointer_ << 8) | data : data;
+    pointerIdx_++;
+    return true;
+  }
+  memory_[pointer_ % memorySize_] = data;
+  if (writePage_)
+  {
+    pointer_ = pointer_ - pointer_ % writePage_ + (pointer_ + 1) % writePage_;
+  }
+  else
+  {
+    pointer_++;
+  }
+  pointer_ %= memorySize_;
+  dataWritten_ = true;
+  return true;
+}
+
+void gbj_twowire_sim_memory::onStop()
+{
+  if (dataWritten_)
+  {
+    busyUntil_ = SimBus.getNanos() + writeCycle_;
+  }
+  dataWritten_ = false;
+}
+
+uint8_t gbj_twowire_sim_memory::onRead()
+{
+  uint8_t data = memory_[pointer_++ % memorySize_];
+  pointer_ %= memorySize_;
+  return data;
+}
+
+bool gbj_twowire_sim_bus::attach(gbj_twowire_sim_device *device)
+{
+  for (uint8_t i = 0; i < DEVICES; i++)
+  {
+    if (devices_[i] == nullptr || devices_[i] == device)
+    {
+      devices_[i] = device;
+      return true;
+    }
+  }
+  return false;
+}
+
+void gbj_twowire_sim_bus::detach(gbj_twowire_sim_device *device)
+{
+  for (uint8_t i = 0; i < DEVICES; i++)
+  {
+    if (devices_[i] == device)
+    {
+      devices_[i] = nullptr;
+    }
+  }
+  if (active_ == device)
+  {
+    active_ = nullptr;
+  }
+  if (waveDevice_ == device)
+  {
+    waveDevice_ = nullptr;
+  }
+}
+
+void gbj_twowire_sim_bus::detachAll()
+{
+  for (uint8_t i = 0; i < DEVICES; i++)
+  {
+    devices_[i] = nullptr;
+  }
+  active_ = waveDevice_ = nullptr;
+}
+
+void gbj_twowire_sim_bus::drive(uint8_t pin, bool low)
+{
+  if (pin == pinSCL_)
+  {
+    if (lowSCL_ && !low)
+    {
+      releaseSCL_ = nanos_;
+    }
+    lowSCL_ = low;
+  }
+  else if (pin == pinSDA_)
+  {
+    lowSDA_ = low;
+  }
+  update();
+  nanos_ += pinNanos_;
+}
+
+bool gbj_twowire_sim_bus::level(uint8_t pin)
+{
+  update();
+  nanos_ += pinNanos_;
+  if (pin == pinSCL_)
+  {
+    return levelSCL_;
+  }
+  if (pin == pinSDA_)
+  {
+    return levelSDA_ && !heldSDA_;
+  }
+  return true;
+}
+
+void gbj_twowire_sim_bus::resetWaveform()
+{
+  wave_.lowNanos = wave_.highNanos = wave_.periodNanos = 0xFFFFFFFF;
+  wave_.startHoldNanos = wave_.startSetupNanos = 0xFFFFFFFF;
+  wave_.stopSetupNanos = wave_.busFreeNanos = 0xFFFFFFFF;
+  wave_.dataSetupNanos = 0xFFFFFFFF;
+  wave_.stretchNanos = 0;
+}
+
+void gbj_twowire_sim_bus::update()
+{
+  // Clock line rises when released by the master and not stretched
+  bool levelSCL = !lowSCL_ && nanos_ >= stretchUntil_;
+  if (levelSCL != levelSCL_)
+  {
+    levelSCL_ = levelSCL;
+    if (levelSCL)
+    {
+      uint64_t time = max(stretchUntil_, releaseSCL_);
+      if (stretchUntil_ > releaseSCL_)
+      {
+        wave_.stretchNanos += stretchUntil_ - releaseSCL_;
+      }
+      onClockRise(time);
+    }
+    else
+    {
+      onClockFall(nanos_);
+    }
+  }
+  // Held data line is a fault outside of the decoded waveform
+  bool levelSDA = !lowSDA_ && !deviceSDA_;
+  if (levelSDA != levelSDA_)
+  {
+    levelSDA_ = levelSDA;
+    onDataChange(nanos_);
+  }
+}
+
+void gbj_twowire_sim_bus::onClockRise(uint64_t time)
+{
+  // Rising edge of a clock pulse shifts out a bit of the holding device
+  stats_.clockPulses++;
+  if (heldSDA_)
+  {
+    heldSDA_--;
+  }
+  if (waveBusy_)
+  {
+    keepMin(wave_.lowNanos, time - fallSCL_);
+    if (riseSCL_ > startTime_)
+    {
+      keepMin(wave_.periodNanos, time - riseSCL_);
+    }
+    if (changeSDA_ > fallSCL_)
+    {
+      keepMin(wave_.dataSetupNanos, time - changeSDA_);
+    }
+  }
+  riseSCL_ = time;
+  switch (waveState_)
+  {
+    case WAVE_ADDRESS:
+    case WAVE_WRITE:
+      waveData_ = (waveData_ << 1) | levelSDA_;
+      waveBits_++;
+      break;
+
+    case WAVE_READ:
+      waveBits_++;
+      break;
+
+    case WAVE_MASTER_ACK:
+      waveAck_ = !levelSDA_;
+      break;
+
+    default:
+      break;
+  }
+}
+
+void gbj_twowire_sim_bus::onClockFall(uint64_t time)
+{
+  if (waveBusy_)
+  {
+    if (startTime_ > riseSCL_)
+    {
+      keepMin(wave_.startHoldNanos, time - startTime_);
+    }
+    else
+    {
+      keepMin(wave_.highNanos, time - riseSCL_);
+    }
+  }
+  fallSCL_ = time;
+  switch (waveState_)
+  {
+    case WAVE_ADDRESS:
+      if (waveBits_ < 8)
+      {
+        break;
+      }
+      stats_.addressBytes++;
+      waveRead_ = waveData_ & 0x01;
+      waveDevice_ = nullptr;
+      if (nackFaults_)
+      {
+        nackFaults_--;
+      }
+      else
+      {
+        for (uint8_t i = 0; i < DEVICES; i++)
+        {
+          if (devices_[i] && devices_[i]->getAddress() == (waveData_ >> 1))
+          {
+            waveDevice_ = devices_[i];
+            break;
+          }
+        }
+      }
+      waveAck_ = waveDevice_ && waveDevice_->onAddress(waveRead_);
+      waveState_ = WAVE_ACK;
+      break;
+
+    case WAVE_WRITE:
+      if (waveBits_ < 8)
+      {
+        break;
+      }
+      stats_.bytesWritten++;
+      waveAck_ = waveDevice_ && waveDevice_->onWrite(waveData_);
+      waveState_ = WAVE_ACK;
+      break;
+
+    // End of the acknowledge clock pulse of the device
+    case WAVE_ACK:
+      deviceSDA_ = false;
+      if (!waveAck_)
+      {
+        waveState_ = WAVE_IDLE;
+        break;
+      }
+      if (stretch_)
+      {
+        stretchUntil_ = time + stretch_;
+      }
+      if (waveRead_)
+      {
+        readNext();
+      }
+      else
+      {
+        waveState_ = WAVE_WRITE;
+        waveBits_ = waveData_ = 0;
+      }
+      return;
+
+    case WAVE_READ:
+      if (waveBits_ < 8)
+      {
+        deviceSDA_ = !(waveData_ & (0x80 >> waveBits_));
+      }
+      else
+      {
+        deviceSDA_ = false;
+        waveState_ = WAVE_MASTER_ACK;
+      }
+      return;
+
+    // End of the acknowledge clock pulse of the master
+    case WAVE_MASTER_ACK:
+      if (waveAck_)
+      {
+        readNext();
+      }
+      else
+      {
+        waveState_ = WAVE_IDLE;
+      }
+      return;
+
+    default:
+      return;
+  }
+  // Acknowledge bit of the device
+  if (waveState_ == WAVE_ACK)
+  {
+    deviceSDA_ = waveAck_;
+    if (!waveAck_)
+    {
+      stats_.nacks++;
+    }
+  }
+}
+
+void gbj_twowire_sim_bus::onDataChange(uint64_t time)
+{
+  changeSDA_ = time;
+  if (!levelSCL_)
+  {
+    return;
+  }
+  // START as falling data line while the clock line is high
+  if (!levelSDA_)
+  {
+    stats_.starts++;
+    if (waveBusy_)
+    {
+      stats_.repeatedStarts++;
+      keepMin(wave_.startSetupNanos, time - riseSCL_);
+    }
+    else
+    {
+      if (waveStopped_)
+      {
+        keepMin(wave_.busFreeNanos, time - stopTime_);
+      }
+      waveBusy_ = true;
+      busyTime_ = time;
+    }
+    startTime_ = time;
+    waveState_ = WAVE_ADDRESS;
+    waveBits_ = waveData_ = 0;
+  }
+  // STOP as rising data line while the clock line is high
+  else if (waveBusy_)
+  {
+    stats_.stops++;
+    stats_.busNanos += time - busyTime_;
+    keepMin(wave_.stopSetupNanos, time - riseSCL_);
+    if (waveDevice_)
+    {
+      waveDevice_->onStop();
+    }
+    waveDevice_ = nullptr;
+    waveBusy_ = false;
+    waveStopped_ = true;
+    waveState_ = WAVE_IDLE;
+    stopTime_ = time;
+  }
+}
+
+void gbj_twowire_sim_bus::readNext()
+{
+  stats_.bytesRead++;
+  // Released bus reads as recessive level
+  waveData_ = waveDevice_ ? waveDevice_->onRead() : 0xFF;
+  waveBits_ = 0;
+  deviceSDA_ = !(waveData_ & 0x80);
+  waveState_ = WAVE_READ;
+}
+
+bool gbj_twowire_sim_bus::start()
+{
+  // Arbitration lost at START on the held data line
+  if (heldSDA_)
+  {
+    stats_.arbitrations++;
+    clockBits(2);
+    active_ = nullptr;
+    busy_ = false;
+    return false;
+  }
+  stats_.starts++;
+  if (busy_)
+  {
+    stats_.repeatedStarts++;
+  }
+  busy_ = true;
+  // Bus free time or repeated START setup, START hold time
+  clockBits(2);
+  return true;
+}
+
+bool gbj_twowire_sim_bus::address(uint8_t address, bool read)
+{
+  stats_.addressBytes++;
+  clockBits(18);
+  active_ = nullptr;
+  if (nackFaults_)
+  {
+    nackFaults_--;
+    stats_.nacks++;
+    return false;
+  }
+  for (uint8_t i = 0; i < DEVICES; i++)
+  {
+    if (devices_[i] && devices_[i]->getAddress() == address)
+    {
+      active_ = devices_[i];
+      break;
+    }
+  }
+  if (active_ == nullptr || !active_->onAddress(read))
+  {
+    active_ = nullptr;
+    stats_.nacks++;
+    return false;
+  }
+  return true;
+}
+
+bool gbj_twowire_sim_bus::write(uint8_t data)
+{
+  stats_.bytesWritten++;
+  clockBits(18);
+  if (active_ == nullptr || !active_->onWrite(data))
+  {
+    stats_.nacks++;
+    return false;
+  }
+  return true;
+}
+
+uint8_t gbj_twowire_sim_bus::read(bool ack)
+{
+  (void)ack;
+  stats_.bytesRead++;
+  clockBits(18);
+  // Released bus reads as recessive level
+  return active_ ? active_->onRead() : 0xFF;
+}
+
+void gbj_twowire_sim_bus::stop()
+{
+  stats_.stops++;
+  clockBits(2);
+  if (active_)
+  {
+    active_->onStop();
+  }
+  active_ = nullptr;
+  busy_ = false;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  txAddress_ = address;
+  txLength_ = 0;
+  txOverflow_ = false;
+}
+
+uint8_t TwoWire::endTransmission(uint8_t sendStop)
+{
+  uint8_t txLength = txLength_;
+  txLength_ = 0;
+  if (txOverflow_)
+  {
+    txOverflow_ = false;
+    return 1;
+  }
+  if (!SimBus.start())
+  {
+    return 4;
+  }
+  if (!SimBus.address(txAddress_, false))
+  {
+    SimBus.stop();
+    return 2;
+  }
+  for (uint8_t i = 0; i < txLength; i++)
+  {
+    if (!SimBus.write(txBuffer_[i]))
+    {
+      SimBus.stop();
+      return 3;
+    }
+  }
+  if (sendStop)
+  {
+    SimBus.stop();
+  }
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address,
+                             uint8_t quantity,
+                             uint8_t sendStop)
+{
+  rxIndex_ = rxLength_ = 0;
+  if (quantity >= BUFFER_LENGTH)
+  {
+    quantity = BUFFER_LENGTH;
+  }
+  if (!SimBus.start())
+  {
+    return 0;
+  }
+  if (!SimBus.address(address, true))
+  {
+    SimBus.stop();
+    return 0;
+  }
+  for (uint8_t i = 0; i < quantity; i++)
+  {
+    rxBuffer_[i] = SimBus.read(i + 1 < quantity);
+  }
+  if (sendStop)
+  {
+    SimBus.stop();
+  }
+  rxLength_ = quantity;
+  return quantity;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+  if (txLength_ >= BUFFER_LENGTH)
+  {
+    txOverflow_ = true;
+    return 0;
+  }
+  txBuffer_[txLength_++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity)
+{
+  if (quantity > static_cast<size_t>(BUFFER_LENGTH - txLength_))
+  {
+    quantity = BUFFER_LENGTH - txLength_;
+    txOverflow_ = true;
+  }
+  memcpy(txBuffer_ + txLength_, data, quantity);
+  txLength_ += quantity;
+  return quantity;
+}
+
+size_t TwoWire::readBytes(uint8_t *buffer, size_t length)
+{
+  if (length > static_cast<size_t>(available()))
+  {
+    length = available();
+  }
+  memcpy(buffer, rxBuffer_ + rxIndex_, length);
+  rxIndex_ += length;
+  return length;
+}
+
+  #if defined(GBJ_TWOWIRE_SIM_MAIN)
+void setup();
+void loop();
+
+int main()
+{
+  setup();
+  while (SimBus.millis() < GBJ_TWOWIRE_SIM_RUNTIME)
+  {
+    loop();
+  }
+  return 0;
+}
+  #endif
+
+#endif
@@ -0,0 +1,557 @@
+/**
+ * @file gbj_twowire_sim.h
+ * @brief Host (Linux) stand-in for the Arduino two-wire environment.
+ * @details Provides the minimal Arduino core shims (timing, String, Serial)
+ * and a TwoWire class driving a simulated two-wire bus with pluggable virtual
+ * slave devices, so that the library and libraries derived from it can be
+ * built, exercised, and measured without a microcontroller.
+ * The simulated bus keeps its own virtual time, which advances by the bit
+ * periods of every START, address, data, and STOP condition at the current
+ * clock speed, so that bus timing does not depend on the host speed.
+ *
+ * @copyright This program is free software; you can redistribute it and/or
+ * modify it under the terms of the MIT License (MIT).
+ *
+ * @author Libor Gabaj
+ * @see https://github.com/mrkaleArduinoLib/gbj_twowire.git
+ */
+#ifndef GBJ_TWOWIRE_SIM_H
+#define GBJ_TWOWIRE_SIM_H
+#define GBJ_TWOWIRE_SIM
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+
+#ifndef BUFFER_LENGTH
+  #define BUFFER_LENGTH 32
+#endif
+#ifndef F_CPU
+  /// Clock frequency of the simulated processor core
+  #define F_CPU 16000000UL
+#endif
+#ifndef GBJ_TWOWIRE_SIM_RUNTIME
+  /// Virtual time in milliseconds, for which the sketch loop runs on host
+  #define GBJ_TWOWIRE_SIM_RUNTIME 1000
+#endif
+#define DEC 10
+#define HEX 16
+// Program memory is ordinary memory on host
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define memcpy_P memcpy
+#define PSTR(str) (str)
+
+typedef uint8_t byte;
+
+/// @name Arduino core timing shims running on the simulated bus time
+/// @{
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+/// @}
+
+/// @name Arduino core GPIO shims driving the simulated bus lines
+/// @{
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+/// @}
+
+template<typename T, typename U>
+inline auto min(T a, U b) -> decltype(a + b)
+{
+  return a < b ? static_cast<decltype(a + b)>(a)
+               : static_cast<decltype(a + b)>(b);
+}
+
+template<typename T, typename U>
+inline auto max(T a, U b) -> decltype(a + b)
+{
+  return a > b ? static_cast<decltype(a + b)>(a)
+               : static_cast<decltype(a + b)>(b);
+}
+
+/**
+ * @class String
+ * @brief Minimal Arduino String stand-in backed by the standard string.
+ */
+class String
+{
+public:
+  String(const char *str = "")
+    : str_(str)
+  {
+  }
+  String(const std::string &str)
+    : str_(str)
+  {
+  }
+  String(int value, uint8_t base = DEC)
+    : str_(toText(value < 0 ? -static_cast<long>(value) : value,
+                  base,
+                  value < 0))
+  {
+  }
+  String(unsigned int value, uint8_t base = DEC)
+    : str_(toText(value, base))
+  {
+  }
+  String(long value, uint8_t base = DEC)
+    : str_(toText(value < 0 ? -value : value, base, value < 0))
+  {
+  }
+  String(unsigned long value, uint8_t base = DEC)
+    : str_(toText(value, base))
+  {
+  }
+  String(double value, uint8_t decimals = 2);
+
+  inline unsigned int length() const { return str_.length(); }
+  inline const char *c_str() const { return str_.c_str(); }
+  inline String &operator+=(const String &rhs)
+  {
+    str_ += rhs.str_;
+    return *this;
+  }
+  inline friend String operator+(const String &lhs, const String &rhs)
+  {
+    return String(lhs.str_ + rhs.str_);
+  }
+  inline bool operator==(const String &rhs) const { return str_ == rhs.str_; }
+
+private:
+  std::string str_;
+
+  static std::string toText(unsigned long value,
+                            uint8_t base,
+                            bool negative = false);
+};
+
+/**
+ * @class HardwareSerial
+ * @brief Serial monitor stand-in writing to the standard output.
+ */
+class HardwareSerial
+{
+public:
+  inline void begin(unsigned long) {}
+  size_t print(const String &text);
+  inline size_t print(const char *text) { return print(String(text)); }
+  inline size_t print(char c) { return print(String(std::string(1, c))); }
+  inline size_t print(int value, int base = DEC)
+  {
+    return print(String(value, base));
+  }
+  inline size_t print(unsigned int value, int base = DEC)
+  {
+    return print(String(value, base));
+  }
+  inline size_t print(long value, int base = DEC)
+  {
+    return print(String(value, base));
+  }
+  inline size_t print(unsigned long value, int base = DEC)
+  {
+    return print(String(value, base));
+  }
+  inline size_t print(double value, int decimals = 2)
+  {
+    return print(String(value, decimals));
+  }
+  inline size_t println() { return print("\n"); }
+  template<typename T>
+  inline size_t println(T value)
+  {
+    return print(value) + println();
+  }
+  template<typename T>
+  inline size_t println(T value, int format)
+  {
+    return print(value, format) + println();
+  }
+};
+extern HardwareSerial Serial;
+
+/**
+ * @class gbj_twowire_sim_device
+ * @brief Virtual slave device attached to the simulated two-wire bus.
+ * @details A device reacts on being addressed, on bytes written by the
+ * master, on bytes requested by the master, and on STOP condition.
+ * Returning false from acknowledging methods generates NACK.
+ */
+class gbj_twowire_sim_device
+{
+public:
+  inline explicit gbj_twowire_sim_device(uint8_t address)
+    : address_(address)
+  {
+  }
+  virtual ~gbj_twowire_sim_device() {}
+
+  inline uint8_t getAddress() { return address_; }
+
+  /**
+   * @brief Device has been addressed after START or repeated START.
+   * @param read Flag about read (true) or write (false) transaction.
+   * @return True for ACK, false for NACK.
+   */
+  virtual bool onAddress(bool read)
+  {
+    (void)read;
+    return true;
+  }
+
+  /**
+   * @brief Master has written a data byte to the device.
+   * @param data Received byte.
+   * @return True for ACK, false for NACK.
+   */
+  virtual bool onWrite(uint8_t data) = 0;
+
+  /**
+   * @brief Master requests a data byte from the device.
+   * @return Byte to be put on the bus.
+   */
+  virtual uint8_t onRead() = 0;
+
+  /**
+   * @brief STOP condition terminated the transaction with the device.
+   */
+  virtual void onStop() {}
+
+protected:
+  uint8_t address_;
+};
+
+/**
+ * @class gbj_twowire_sim_memory
+ * @brief Register file or EEPROM like virtual device.
+ * @details The first bytes of every write transaction set the memory pointer
+ * (1 or 2 bytes, MSB first), the other ones are stored from the pointer on.
+ * Reading returns bytes from the pointer on. The pointer auto-increments and
+ * wraps around the memory size. With zero pointer bytes the device behaves as
+ * a stream, which stores and returns bytes sequentially.
+ * With a write cycle time set, the device does not acknowledge its address
+ * for that time after STOP terminating a transaction with written data, as
+ * an EEPROM does. With a write page size set, written data wrap around
+ * within the page of the pointer, as in an EEPROM.
+ */
+class gbj_twowire_sim_memory : public gbj_twowire_sim_device
+{
+public:
+  gbj_twowire_sim_memory(uint8_t address,
+                         uint8_t *memory,
+                         uint16_t memorySize,
+                         uint8_t pointerBytes = 1)
+    : gbj_twowire_sim_device(address)
+    , memory_(memory)
+    , memorySize_(memorySize)
+    , pointerBytes_(pointerBytes)
+  {
+  }
+
+  bool onAddress(bool read) override;
+  bool onWrite(uint8_t data) override;
+  uint8_t onRead() override;
+  void onStop() override;
+
+  inline uint16_t getPointer() { return pointer_; }
+  inline void setWriteCycle(uint32_t us) { writeCycle_ = 1000ULL * us; }
+  inline void setWritePage(uint16_t size) { writePage_ = size; }
+
+protected:
+  uint8_t *memory_;
+  uint16_t memorySize_;
+  uint8_t pointerBytes_;
+  uint8_t pointerIdx_ = 0;
+  uint16_t pointer_ = 0;
+  uint64_t writeCycle_ = 0;
+  uint64_t busyUntil_ = 0;
+  uint16_t writePage_ = 0;
+  bool dataWritten_ = false;
+};
+
+/**
+ * @class gbj_twowire_sim_bus
+ * @brief Simulated two-wire bus with virtual time.
+ * @details The bus is a single physical medium shared by all TwoWire
+ * instances, as the hardware bus is. Every bus condition advances the virtual
+ * time by the corresponding number of clock periods. Reading the time by
+ * millis() or micros() advances it by a small tick as well, so that polling
+ * loops waiting for a timestamp terminate.
+ * Faults can be injected for testing of recovery: NACKs of a number of next
+ * addressings, and the data line held low by a device until a number of
+ * clock pulses is generated on the clock line driven as a GPIO pin. While
+ * the data line is held, no START can be generated.
+ * Bus lines driven as GPIO pins, e.g., by a bit-banged transport, are
+ * decoded at the waveform level: START, STOP, address, data, and acknowledge
+ * bits reach the attached devices, which drive the data line back, and
+ * optionally stretch the clock line after every acknowledged byte. Every GPIO
+ * access takes the pin time of the simulated core, and minimal timing
+ * parameters of the waveform are measured.
+ */
+class gbj_twowire_sim_bus
+{
+public:
+  static const uint8_t DEVICES = 16;
+
+  struct Statistics
+  {
+    /// START conditions including repeated ones
+    uint32_t starts;
+    /// Repeated START conditions
+    uint32_t repeatedStarts;
+    /// STOP conditions
+    uint32_t stops;
+    /// Address bytes on the bus
+    uint32_t addressBytes;
+    /// Data bytes written by master
+    uint32_t bytesWritten;
+    /// Data bytes read by master
+    uint32_t bytesRead;
+    /// NACKed address or data bytes
+    uint32_t nacks;
+    /// START conditions failed due to the data line held low
+    uint32_t arbitrations;
+    /// Clock pulses generated on the clock line driven as a GPIO pin
+    uint32_t clockPulses;
+    /// Time the bus has been occupied in nanoseconds
+    uint64_t busNanos;
+  };
+
+  /// Minimal timing parameters of the waveform on GPIO driven lines within
+  /// transactions in nanoseconds, 0xFFFFFFFF if not measured yet
+  struct Waveform
+  {
+    /// Clock low time (tLOW)
+    uint32_t lowNanos;
+    /// Clock high time (tHIGH)
+    uint32_t highNanos;
+    /// Clock period between rising edges
+    uint32_t periodNanos;
+    /// Hold time of START or repeated START (tHD;STA)
+    uint32_t startHoldNanos;
+    /// Setup time of repeated START (tSU;STA)
+    uint32_t startSetupNanos;
+    /// Setup time of STOP (tSU;STO)
+    uint32_t stopSetupNanos;
+    /// Bus free time between STOP and START (tBUF)
+    uint32_t busFreeNanos;
+    /// Data setup time (tSU;DAT)
+    uint32_t dataSetupNanos;
+    /// Total time the clock line has been stretched by devices
+    uint64_t stretchNanos;
+  };
+
+  /**
+   * @brief Attach virtual device to the bus.
+   * @return True if attached, false if no free slot.
+   */
+  bool attach(gbj_twowire_sim_device *device);
+  void detach(gbj_twowire_sim_device *device);
+  void detachAll();
+
+  inline void setClock(uint32_t clock) { clock_ = clock ? clock : clock_; }
+  inline uint32_t getClock() { return clock_; }
+
+  /// @name Virtual time
+  /// @{
+  inline uint64_t getNanos() { return nanos_; }
+  inline void advance(uint64_t nanos) { nanos_ += nanos; }
+  inline void setTick(uint32_t nanos) { tick_ = nanos; }
+  inline uint32_t micros()
+  {
+    nanos_ += tick_;
+    return static_cast<uint32_t>(nanos_ / 1000);
+  }
+  inline uint32_t millis()
+  {
+    nanos_ += tick_;
+    return static_cast<uint32_t>(nanos_ / 1000000);
+  }
+  /// @}
+
+  inline const Statistics &getStatistics() { return stats_; }
+  inline void resetStatistics() { stats_ = Statistics(); }
+  inline const Waveform &getWaveform() { return wave_; }
+  void resetWaveform();
+
+  /// @name Fault injection
+  /// @{
+  inline void injectNacks(uint8_t count) { nackFaults_ = count; }
+  inline void injectHeldSDA(uint8_t clockPulses) { heldSDA_ = clockPulses; }
+  inline bool isHeldSDA() { return heldSDA_ > 0; }
+  /// @}
+
+  /// @name Bus lines driven by GPIO shims
+  /// @{
+  inline void setPins(uint8_t pinSDA, uint8_t pinSCL)
+  {
+    pinSDA_ = pinSDA;
+    pinSCL_ = pinSCL;
+  }
+  void drive(uint8_t pin, bool low);
+  bool level(uint8_t pin);
+  /// Time of a GPIO access of the simulated core in nanoseconds
+  inline void setPinTime(uint32_t nanos) { pinNanos_ = nanos; }
+  inline uint32_t getPinTime() { return pinNanos_; }
+  /// Time the devices hold the clock line low after every acknowledged byte
+  /// of GPIO driven transactions in nanoseconds
+  inline void setStretch(uint32_t nanos) { stretch_ = nanos; }
+  /// @}
+
+  /// @name Bus conditions used by the TwoWire stand-in
+  /// @{
+  bool start();
+  bool address(uint8_t address, bool read);
+  bool write(uint8_t data);
+  uint8_t read(bool ack);
+  void stop();
+  /// @}
+
+private:
+  gbj_twowire_sim_device *devices_[DEVICES] = {};
+  gbj_twowire_sim_device *active_ = nullptr;
+  Statistics stats_ = Statistics();
+  uint64_t nanos_ = 0;
+  uint32_t tick_ = 250;
+  uint32_t clock_ = 100000;
+  bool busy_ = false;
+  uint8_t nackFaults_ = 0;
+  uint8_t heldSDA_ = 0;
+  uint8_t pinSDA_ = 4;
+  uint8_t pinSCL_ = 5;
+  bool lowSDA_ = false;
+  bool lowSCL_ = false;
+  // Two cycles of the default core, i.e., a direct port access
+  uint32_t pinNanos_ = 2000000000ULL / F_CPU;
+
+  /// @name Waveform decoder of GPIO driven lines
+  /// @{
+  enum WaveStates : uint8_t
+  {
+    WAVE_IDLE,
+    WAVE_ADDRESS,
+    WAVE_WRITE,
+    WAVE_ACK,
+    WAVE_READ,
+    WAVE_MASTER_ACK,
+  };
+  Waveform wave_ = {
+    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+    0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0,
+  };
+  WaveStates waveState_ = WAVE_IDLE;
+  gbj_twowire_sim_device *waveDevice_ = nullptr;
+  bool waveBusy_ = false;
+  bool waveStopped_ = false;
+  bool waveRead_ = false;
+  bool waveAck_ = false;
+  uint8_t waveBits_ = 0;
+  uint8_t waveData_ = 0;
+  bool levelSDA_ = true;
+  bool levelSCL_ = true;
+  bool deviceSDA_ = false; // Device drives the data line low
+  uint32_t stretch_ = 0;
+  uint64_t stretchUntil_ = 0;
+  uint64_t releaseSCL_ = 0;
+  uint64_t riseSCL_ = 0;
+  uint64_t fallSCL_ = 0;
+  uint64_t changeSDA_ = 0;
+  uint64_t startTime_ = 0;
+  uint64_t stopTime_ = 0;
+  uint64_t busyTime_ = 0;
+
+  void update();
+  void onClockRise(uint64_t time);
+  void onClockFall(uint64_t time);
+  void onDataChange(uint64_t time);
+  void readNext();
+  static inline void keepMin(uint32_t &minimum, uint64_t nanos)
+  {
+    if (nanos < minimum)
+    {
+      minimum = static_cast<uint32_t>(nanos);
+    }
+  }
+  /// @}
+
+  inline void clockBits(uint8_t halfBits)
+  {
+    uint64_t nanos = 500000000ULL * halfBits / clock_;
+    nanos_ += nanos;
+    stats_.busNanos += nanos;
+  }
+};
+extern gbj_twowire_sim_bus SimBus;
+
+/**
+ * @class TwoWire
+ * @brief Host stand-in of the Arduino TwoWire library on the simulated bus.
+ * @details It follows the AVR implementation: transmission is buffered up to
+ * BUFFER_LENGTH bytes and put on the bus at endTransmission(), reception is
+ * limited to BUFFER_LENGTH bytes per request. Writing over the buffer length
+ * makes endTransmission() fail with code 1 without any bus activity.
+ */
+class TwoWire
+{
+public:
+  inline void begin() { txLength_ = rxLength_ = rxIndex_ = 0; }
+  inline void begin(int pinSDA, int pinSCL)
+  {
+    SimBus.setPins(pinSDA, pinSCL);
+    begin();
+  }
+  inline void end() {}
+  inline void setClock(uint32_t clock) { SimBus.setClock(clock); }
+
+  void beginTransmission(uint8_t address);
+  inline void beginTransmission(int address)
+  {
+    beginTransmission(static_cast<uint8_t>(address));
+  }
+  uint8_t endTransmission(uint8_t sendStop = true);
+  uint8_t requestFrom(uint8_t address,
+                      uint8_t quantity,
+                      uint8_t sendStop = true);
+  inline uint8_t requestFrom(int address, int quantity, int sendStop = true)
+  {
+    return requestFrom(static_cast<uint8_t>(address),
+                       static_cast<uint8_t>(quantity),
+                       static_cast<uint8_t>(sendStop));
+  }
+
+  // Virtual like the Stream methods of Arduino cores
+  virtual ~TwoWire() {}
+  virtual size_t write(uint8_t data);
+  virtual size_t write(const uint8_t *data, size_t quantity);
+  virtual int available() { return rxLength_ - rxIndex_; }
+  virtual int read() { return rxIndex_ < rxLength_ ? rxBuffer_[rxIndex_++] : -1; }
+  virtual int peek() { return rxIndex_ < rxLength_ ? rxBuffer_[rxIndex_] : -1; }
+  virtual void flush() {}
+  size_t readBytes(uint8_t *buffer, size_t length);
+  inline size_t readBytes(char *buffer, size_t length)
+  {
+    return readBytes(reinterpret_cast<uint8_t *>(buffer), length);
+  }
+
+private:
+  uint8_t txAddress_ = 0;
+  uint8_t txBuffer_[BUFFER_LENGTH];
+  uint8_t txLength_ = 0;
+  bool txOverflow_ = false;
+  uint8_t rxBuffer_[BUFFER_LENGTH];
+  uint8_t rxLength_ = 0;
+  uint8_t rxIndex_ = 0;
+};
+extern TwoWire Wire;
+
+#endif